@@ -9,5 +9,29 @@ PHP_ARG_ENABLE(explain, whether to enable explain support,
 [  --enable-explain           Enable explain support], yes, yes)
 
 if test "$PHP_EXPLAIN" != "no"; then
+  dnl explain_opcodes.h is generated from the VM we are building against
+  AC_MSG_CHECKING([for zend_vm_opcodes.h])
+  EXPLAIN_VM_OPCODES=
+  for i in $abs_srcdir/Zend $phpincludedir/Zend $prefix/include/php/Zend; do
+    if test -r "$i/zend_vm_opcodes.h"; then
+      EXPLAIN_VM_OPCODES="$i/zend_vm_opcodes.h"
+      break
+    fi
+  done
+
+  if test -z "$EXPLAIN_VM_OPCODES"; then
+    AC_MSG_RESULT([not found])
+    AC_MSG_ERROR([Cannot find zend_vm_opcodes.h, explain_opcodes.h cannot be generated])
+  fi
+  AC_MSG_RESULT([$EXPLAIN_VM_OPCODES])
+
   PHP_NEW_EXTENSION(explain, explain.c, $ext_shared)
+
+  AC_MSG_NOTICE([generating $ext_builddir/explain_opcodes.h])
+  test -d "$ext_builddir" || mkdir -p "$ext_builddir"
+  ${AWK:-awk} -f $ext_srcdir/explain_opcodes.awk $ext_srcdir/explain_opcodes.kinds \
+    "$EXPLAIN_VM_OPCODES" $ext_srcdir/explain_opcodes.h.in > $ext_builddir/explain_opcodes.h || \
+    AC_MSG_ERROR([failed to generate explain_opcodes.h])
+
+  PHP_ADD_INCLUDE($ext_builddir)
 fi
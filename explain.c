@@ -26,46 +26,115 @@
 #include "php_ini.h"
 #include "php_main.h"
 #include "ext/standard/info.h"
+#include "ext/standard/html.h"
+#include "ext/standard/php_lcg.h"
+#include "zend_smart_str.h"
+#include "zend_closures.h"
 #include "php_explain.h"
 
 typedef struct _explain_opcode_t {
     const char *name;
     size_t  name_len;
     zend_uchar opcode;
+    uint32_t kind;
+    zend_string *string;
 } explain_opcode_t;
 
 #define EXPLAIN_FILE   0x00000001
 #define EXPLAIN_STRING 0x00000010
 #define EXPLAIN_OPLINE 0x00000011
 
-#define EXPLAIN_OPCODE_NAME(c) \
-	{#c, sizeof(#c)-1, c}
+/* roll the class and function tables back after explaining, the entries
+    themselves stay in the compiler arena until the end of the request */
+#define EXPLAIN_ISOLATE 0x00000200
+/* add declarations and call sites to the symbol index */
+#define EXPLAIN_INDEX   0x00000400
+/* annotate operands with their inferred types */
+#define EXPLAIN_TYPES   0x00000800
+
+/* operand kinds, see explain_opcodes.kinds */
+#define EXPLAIN_OP1_OPLINE  (1<<0)
+#define EXPLAIN_OP2_OPLINE  (1<<1)
+#define EXPLAIN_EXT_OPLINE  (1<<2)
+#define EXPLAIN_RESULT_ONLY (1<<3)
+
+#define EXPLAIN_OPCODE_NAME(c, k) \
+	{#c, sizeof(#c)-1, c, k, NULL}
 
 #include "explain_opcodes.h"
 
+#define EXPLAIN_OPCODES_SIZE (sizeof(opcodes) / sizeof(explain_opcode_t))
+
 #if ZEND_USE_ABS_JMP_ADDR
-# define JMP_LINE(node, base_address)  (int32_t)(((long)((node).jmp_addr) - (long)(base_address)) / sizeof(zend_op))
+# define JMP_LINE(node, base_address)  (int32_t)(((zend_op*)((node).jmp_addr)) - (base_address))
 #else
-# define JMP_LINE(node, opline)  (int32_t)(((int32_t)((node).jmp_offset) / sizeof(zend_op)) + (opline))
+# define JMP_LINE(node, opline)  (int32_t)(((int32_t)((node).jmp_offset) / (int32_t) sizeof(zend_op)) + (opline))
 #endif
 
-ZEND_DECLARE_MODULE_GLOBALS(explain);
+#define EXT_LINE(value, opline) (int32_t)(((int32_t)(value) / (int32_t) sizeof(zend_op)) + (opline))
+
+static inline int32_t explain_jmp_line(zend_op_array *ops, znode_op *node, zend_ulong next) { /* {{{ */
+#if ZEND_USE_ABS_JMP_ADDR
+    return JMP_LINE(*node, ops->opcodes);
+#else
+    return JMP_LINE(*node, next);
+#endif
+} /* }}} */
 
-static inline void explain_opcode(long opcode, zval *return_value) { /* {{{ */
+ZEND_DECLARE_MODULE_GLOBALS(explain);
 
-    if (opcode >= sizeof(opcodes)) {
-        ZVAL_STRINGL(return_value, "unknown", strlen("unknown"));
+static inline const explain_opcode_t* explain_opcode_decode(zend_long opcode) { /* {{{ */
+    if (opcode < 0 || (zend_ulong) opcode >= EXPLAIN_OPCODES_SIZE || !opcodes[opcode].name) {
+        return NULL;
     }
 
-    explain_opcode_t decode = opcodes[opcode];
+    return &opcodes[opcode];
+} /* }}} */
+
+static inline void explain_opcode(zend_long opcode, zval *return_value) { /* {{{ */
+    const explain_opcode_t *decode = explain_opcode_decode(opcode);
 
-    if (decode.opcode == opcode) {
-        ZVAL_STRINGL(return_value, decode.name, decode.name_len);
+    if (decode) {
+        ZVAL_INTERNED_STR(return_value, decode->string);
     } else {
         ZVAL_STRINGL(return_value, "unknown", strlen("unknown"));
     }
 } /* }}} */
 
+static inline void explain_opcodes_startup(void) { /* {{{ */
+    zend_ulong opcode;
+
+    for (opcode = 0; opcode < EXPLAIN_OPCODES_SIZE; opcode++) {
+        explain_opcode_t *decode = &opcodes[opcode];
+
+        if (!decode->name) {
+            continue;
+        }
+
+        decode->string = zend_new_interned_string(zend_string_init(decode->name, decode->name_len, 1));
+
+#ifdef ZEND_VM_OP_JMP_ADDR
+        {
+            /* the vm knows better than a list of names */
+            uint32_t flags = zend_get_opcode_flags(decode->opcode);
+
+            if ((ZEND_VM_OP1_FLAGS(flags) & ZEND_VM_OP_MASK) == ZEND_VM_OP_JMP_ADDR) {
+                decode->kind |= EXPLAIN_OP1_OPLINE;
+            }
+
+            if ((ZEND_VM_OP2_FLAGS(flags) & ZEND_VM_OP_MASK) == ZEND_VM_OP_JMP_ADDR) {
+                decode->kind |= EXPLAIN_OP2_OPLINE;
+            }
+# ifdef ZEND_VM_EXT_JMP_ADDR
+            if ((flags & ZEND_VM_EXT_MASK) == ZEND_VM_EXT_JMP_ADDR) {
+                decode->kind |= EXPLAIN_EXT_OPLINE;
+            }
+# endif
+        }
+#endif
+    }
+} /* }}} */
+
 /* True global resources - no need for thread safety here */
 static int le_explain;
 
@@ -103,7 +172,7 @@ static inline void explain_zend_op(zend_op_array *ops, znode_op *op, zend_ulong
 
     switch (type) {
         case IS_CV : {
-            add_assoc_str_ex(return_value_ptr, name, name_len, ops->vars[(op->var - sizeof(zend_execute_data)) / sizeof(zval)]);
+            add_assoc_str_ex(return_value_ptr, name, name_len, zend_string_copy(ops->vars[(op->var - sizeof(zend_execute_data)) / sizeof(zval)]));
             break;
         }
 
@@ -115,7 +184,9 @@ static inline void explain_zend_op(zend_op_array *ops, znode_op *op, zend_ulong
         }
 
         case IS_CONST : {
-            zval pzval = *RT_CONSTANT_EX(ops->literals, *op);
+            zval pzval;
+
+            ZVAL_COPY(&pzval, RT_CONSTANT_EX(ops->literals, *op));
             add_assoc_zval_ex(return_value_ptr, name, name_len, &pzval);
             break;
         }
@@ -169,6 +240,44 @@ static inline void explain_optype(uint32_t type, zval *return_value_ptr) { /* {{
     }
 } /* }}} */
 
+static inline void explain_opline(zend_op_array *ops, zend_ulong next, zend_llist *vars, zval *zopline) { /* {{{ */
+    zend_op *opline = &ops->opcodes[next];
+    const explain_opcode_t *decode = explain_opcode_decode(opline->opcode);
+
+    array_init(zopline);
+
+    add_assoc_long_ex(zopline, "opline", sizeof("opline") - 1, next);
+    add_assoc_long_ex(zopline, "opcode", sizeof("opcode") - 1, opline->opcode);
+
+    if (decode && (decode->kind & EXPLAIN_OP1_OPLINE)) {
+        add_assoc_long_ex(zopline, "op1_type", sizeof("op1_type") - 1, EXPLAIN_OPLINE);
+        add_assoc_long_ex(zopline, "op1", sizeof("op1") - 1, explain_jmp_line(ops, &opline->op1, next));
+    } else if (!decode || !(decode->kind & EXPLAIN_RESULT_ONLY)) {
+        add_assoc_long_ex(zopline, "op1_type", sizeof("op1_type") - 1, opline->op1_type);
+        explain_zend_op(ops, &opline->op1, opline->op1_type, "op1", sizeof("op1") - 1, vars, zopline);
+    }
+
+    if (decode && (decode->kind & EXPLAIN_OP2_OPLINE)) {
+        add_assoc_long_ex(zopline, "op2_type", sizeof("op2_type") - 1, EXPLAIN_OPLINE);
+        add_assoc_long_ex(zopline, "op2", sizeof("op2") - 1, explain_jmp_line(ops, &opline->op2, next));
+    } else if (!decode || !(decode->kind & EXPLAIN_RESULT_ONLY)) {
+        add_assoc_long_ex(zopline, "op2_type", sizeof("op2_type") - 1, opline->op2_type);
+        explain_zend_op(ops, &opline->op2, opline->op2_type, "op2", sizeof("op2") - 1, vars, zopline);
+    }
+
+    add_assoc_long_ex(zopline, "result_type", sizeof("result_type") - 1, opline->result_type);
+    explain_zend_op(ops, &opline->result, opline->result_type, "result", sizeof("result") - 1, vars, zopline);
+
+    if (decode && (decode->kind & EXPLAIN_EXT_OPLINE)) {
+        /* extended_value is a jump offset, report the target opline */
+        add_assoc_long_ex(zopline, "extended_value", sizeof("extended_value") - 1, EXT_LINE(opline->extended_value, next));
+    } else if (opline->extended_value) {
+        add_assoc_long_ex(zopline, "extended_value", sizeof("extended_value") - 1, opline->extended_value);
+    }
+
+    add_assoc_long_ex(zopline, "lineno", sizeof("lineno") - 1, opline->lineno);
+} /* }}} */
+
 static inline void explain_op_array(zend_op_array *ops, zval *result) {
     if (ops) {
         zend_ulong  next = 0;
@@ -179,330 +288,3858 @@ static inline void explain_op_array(zend_op_array *ops, zval *result) {
 
         do {
             zval zopline;
-            array_init(&zopline);
 
-            zend_op *opline = &ops->opcodes[next];
+            explain_opline(ops, next, &vars, &zopline);
 
-            add_assoc_long_ex(&zopline, "opline", sizeof("opline") - 1, next);
-            add_assoc_long_ex(&zopline, "opcode", sizeof("opcode") - 1, opline->opcode);
+            add_next_index_zval(result, &zopline);
+        } while (++next < ops->last);
 
-            switch (opline->opcode) {
-                case ZEND_JMP:
-#ifdef ZEND_GOTO
-                case ZEND_GOTO:
-#endif
-#ifdef ZEND_FAST_CALL
-                case ZEND_FAST_CALL:
-#endif
-                add_assoc_long_ex(&zopline, "op1_type", sizeof("op1_type") - 1, EXPLAIN_OPLINE);
+        zend_llist_destroy(&vars);
+    } else {
+        ZVAL_NULL(result);
+    }
+}
 
-#if ZEND_USE_ABS_JMP_ADDR
-                zend_op *base_address = &(opa->opcodes[0]);
-                add_assoc_long_ex(&zopline, "op1", sizeof("op1") - 1, JMP_LINE(opline->op1, base_address));
-#else
-                add_assoc_long_ex(&zopline, "op1", sizeof("op1") - 1, JMP_LINE(opline->op1, next));
-#endif
+/* {{{ {main}, the function name or Class::method */
+static inline zend_string* explain_op_array_name(zend_op_array *ops) {
+    if (!ops->function_name) {
+        return zend_string_init("{main}", sizeof("{main}") - 1, 0);
+    }
 
-                break;
+    if (ops->scope) {
+        return strpprintf(0, "%s::%s", ZSTR_VAL(ops->scope->name), ZSTR_VAL(ops->function_name));
+    }
 
-                case ZEND_JMPZNZ:
-                    add_assoc_long_ex(&zopline, "op1_type", sizeof("op1_type") - 1, opline->op1_type);
-                    explain_zend_op(ops, &opline->op1, opline->op1_type, "op1", sizeof("op1") - 1, &vars, &zopline);
+    return zend_string_copy(ops->function_name);
+} /* }}} */
 
-                    /* TODO(krakjoe) needs opline->extended_value on true, opline_num on false */
-                    add_assoc_long_ex(&zopline, "op2_type", sizeof("op2_type") - 1, EXPLAIN_OPLINE);
-                    add_assoc_long_ex(&zopline, "op2", sizeof("op2") - 1, opline->op2.opline_num);
+typedef struct _explain_snapshot_t {
+    uint32_t classes;
+    uint32_t functions;
+    uint32_t class_elements;
+    uint32_t function_elements;
+} explain_snapshot_t;
 
-                    add_assoc_long_ex(&zopline, "result_type", sizeof("result_type") - 1, opline->result_type);
-                    explain_zend_op(ops, &opline->result, opline->result_type, "result", sizeof("result") - 1, &vars, &zopline);
-                    break;
+/* {{{ compiling appends to the class and function tables, and only ever deletes
+    what it appended itself (early binding drops runtime definition keys), so
+    once explain_snapshot_settle() has run, classes and functions are the index
+    of the first declaration in each table */
+#define EXPLAIN_FOREACH_DECLARED_BUCKET(ht, from) do { \
+    uint32_t _idx; \
+    for (_idx = (from); _idx < (ht)->nNumUsed; _idx++) { \
+        Bucket *_p = (ht)->arData + _idx; \
+        if (Z_TYPE(_p->val) == IS_UNDEF) continue;
 
-                case ZEND_JMPZ:
-                case ZEND_JMPNZ:
-                case ZEND_JMPZ_EX:
-                case ZEND_JMPNZ_EX:
+#define EXPLAIN_FOREACH_DECLARED(ht, from, _key, _ptr) \
+    EXPLAIN_FOREACH_DECLARED_BUCKET(ht, from) \
+        _key = _p->key; \
+        _ptr = Z_PTR(_p->val);
 
-#ifdef ZEND_JMP_SET
-                case ZEND_JMP_SET:
-#endif
-#ifdef ZEND_JMP_SET_VAR
-                case ZEND_JMP_SET_VAR:
-#endif
-                    add_assoc_long_ex(&zopline, "op1_type", sizeof("op1_type") - 1, opline->op1_type);
-                    explain_zend_op(ops, &opline->op1, opline->op1_type, "op1", sizeof("op1") - 1, &vars, &zopline);
+#define EXPLAIN_FOREACH_DECLARED_PTR(ht, from, _ptr) \
+    EXPLAIN_FOREACH_DECLARED_BUCKET(ht, from) \
+        _ptr = Z_PTR(_p->val);
 
-                    add_assoc_long_ex(&zopline, "op2_type", sizeof("op2_type") - 1, EXPLAIN_OPLINE);
-#if ZEND_USE_ABS_JMP_ADDR
-                    zend_op *base_address = &(opa->opcodes[0]);
-                    add_assoc_long_ex(&zopline, "op2", sizeof("op2") - 1, JMP_LINE(opline->op2, base_address));
-#else
-                    add_assoc_long_ex(&zopline, "op2", sizeof("op2") - 1, JMP_LINE(opline->op2, next));
-#endif
-                    add_assoc_long_ex(&zopline, "result_type", sizeof("result_type") - 1, opline->result_type);
+#define EXPLAIN_FOREACH_END() \
+    } \
+} while (0) /* }}} */
 
-                    explain_zend_op(ops, &opline->result, opline->result_type, "result", sizeof("result") - 1, &vars, &zopline);
-                    break;
+static inline void explain_snapshot(explain_snapshot_t *snapshot) { /* {{{ */
+    snapshot->classes = CG(class_table)->nNumUsed;
+    snapshot->functions = CG(function_table)->nNumUsed;
+    snapshot->class_elements = CG(class_table)->nNumOfElements;
+    snapshot->function_elements = CG(function_table)->nNumOfElements;
+} /* }}} */
 
-                case ZEND_RECV_INIT:
-                    add_assoc_long_ex(&zopline, "result_type", sizeof("result_type") - 1, opline->result_type);
-                    explain_zend_op(ops, &opline->result, opline->result_type, "result", sizeof("result") - 1, &vars, &zopline);
-                    break;
+/* {{{ growing a table with holes compacts it in place, which moves every bucket
+    after the first hole, so where holes existed the position is recounted from
+    the number of entries that were there before compiling */
+static inline uint32_t explain_snapshot_position(HashTable *table, uint32_t used, uint32_t elements) {
+    uint32_t idx, live = 0;
 
-                default: {
-                    add_assoc_long_ex(&zopline, "op1_type", sizeof("op1_type") - 1, opline->op1_type);
-                    explain_zend_op(ops, &opline->op1, opline->op1_type, "op1", sizeof("op1") - 1, &vars, &zopline);
+    if (used == elements) {
+        /* no holes, nothing before used can move */
+        return used;
+    }
 
-                    add_assoc_long_ex(&zopline, "op2_type", sizeof("op2_type") - 1, opline->op2_type);
-                    explain_zend_op(ops, &opline->op2, opline->op2_type, "op2", sizeof("op2") - 1, &vars, &zopline);
+    for (idx = 0; idx < table->nNumUsed && live < elements; idx++) {
+        if (Z_TYPE(table->arData[idx].val) != IS_UNDEF) {
+            live++;
+        }
+    }
 
-                    add_assoc_long_ex(&zopline, "result_type", sizeof("result_type") - 1, opline->result_type);
-                    explain_zend_op(ops, &opline->result, opline->result_type, "result", sizeof("result") - 1, &vars, &zopline);
-                }
-            }
+    return idx;
+} /* }}} */
 
-            if (opline->extended_value) {
-                add_assoc_long_ex(&zopline, "extended_value", sizeof("extended_value") - 1, opline->extended_value);
-            }
+static inline void explain_snapshot_settle(explain_snapshot_t *snapshot) { /* {{{ */
+    snapshot->classes = explain_snapshot_position(CG(class_table), snapshot->classes, snapshot->class_elements);
+    snapshot->functions = explain_snapshot_position(CG(function_table), snapshot->functions, snapshot->function_elements);
+} /* }}} */
 
-            add_assoc_long_ex(&zopline, "lineno", sizeof("lineno") - 1, opline->lineno);
+static inline void explain_rollback_table(HashTable *table, uint32_t from) { /* {{{ */
+    /* deleting the last bucket trims nNumUsed, so this walks backwards
+        through the declarations, destroying each with the table dtor */
+    while (table->nNumUsed > from) {
+        zend_hash_del_bucket(table, table->arData + table->nNumUsed - 1);
+    }
+} /* }}} */
 
-            add_next_index_zval(result, &zopline);
-        } while (++next < ops->last);
+static inline void explain_rollback(explain_snapshot_t *snapshot) { /* {{{ */
+    explain_rollback_table(CG(function_table), snapshot->functions);
+    explain_rollback_table(CG(class_table), snapshot->classes);
+} /* }}} */
 
-        zend_llist_destroy(&vars);
-    } else {
-        ZVAL_NULL(result);
-    }
-}
+/* {{{ move what a compilation declared out of the global tables and into
+    private tables, which destroy it with the same dtors when destroyed */
+static inline void explain_detach_table(HashTable *table, uint32_t from, HashTable *into) {
+    dtor_func_t dtor = table->pDestructor;
+    zend_string *key;
+    void *ptr;
 
-static inline void explain_create_caches(HashTable *classes, HashTable *functions) { /* {{{ */
-    zend_function tf;
-    zend_class_entry *te;
+    zend_hash_init(into, 8, NULL, dtor, 0);
 
-    zend_hash_init(classes, zend_hash_num_elements(classes), NULL, NULL, 0);
-    zend_hash_copy(classes, CG(class_table), NULL);
+    EXPLAIN_FOREACH_DECLARED(table, from, key, ptr) {
+        zend_hash_add_new_ptr(into, key, ptr);
+    } EXPLAIN_FOREACH_END();
 
-    zend_hash_init(functions, zend_hash_num_elements(functions), NULL, NULL, 0);
-    zend_hash_copy(functions, CG(function_table), NULL);
+    table->pDestructor = NULL;
+    explain_rollback_table(table, from);
+    table->pDestructor = dtor;
 } /* }}} */
 
-static inline void explain_destroy_caches(HashTable *classes, HashTable *functions) { /* {{{ */
-    zend_hash_destroy(classes);
-    zend_hash_destroy(functions);
+static inline void php_explain_destroy_ops(zend_op_array **ops) { /* {{{ */
+    if ((*ops)) {
+        destroy_op_array(*ops);
+        efree(*ops);
+    }
 } /* }}} */
 
-/* Every user-visible function in PHP should document itself in the source */
-/* {{{ proto string confirm_explain_compiled(string arg)
-   Return a string to confirm that the module is compiled in */
-PHP_FUNCTION(explain)
-{
-    zval *code, *classes, *functions, res;
-    zend_ulong options = EXPLAIN_FILE;
-    HashTable caches[2] = {0, 0};
+/* {{{ release everything a compilation produced, once it has been decoded */
+static inline void explain_release(zend_op_array **ops, explain_snapshot_t *snapshot, zend_ulong options) {
+    php_explain_destroy_ops(ops);
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "z|lzz", &code, &options, &classes, &functions) == FAILURE) {
-        return;
+    if (options & EXPLAIN_ISOLATE) {
+        explain_rollback(snapshot);
     }
+} /* }}} */
 
+static zend_op_array* explain_compile(zval *code, zend_ulong options, explain_snapshot_t *snapshot) { /* {{{ */
     zend_file_handle fh;
     zend_op_array *ops = NULL;
 
+    if (Z_TYPE_P(code) != IS_STRING) {
+        zend_error(E_WARNING, "explain expects code to be a string");
+        return NULL;
+    }
+
     if (options & EXPLAIN_FILE) {
         if (php_stream_open_for_zend_ex(Z_STRVAL_P(code), &fh, USE_PATH|STREAM_OPEN_FOR_INCLUDE) == SUCCESS) {
-            explain_create_caches(&caches[0], &caches[1]);
+            explain_snapshot(snapshot);
             ops = zend_compile_file(&fh, ZEND_INCLUDE);
             zend_destroy_file_handle(&fh);
         } else {
             zend_error(E_WARNING, "file %s couldn't be opened", Z_STRVAL_P(code));
-            RETURN_FALSE;
+            return NULL;
         }
     } else if (options & EXPLAIN_STRING) {
-        explain_create_caches(&caches[0], &caches[1]);
+        explain_snapshot(snapshot);
         ops = zend_compile_string(code, "explained");
-        if (!ops) {
-            explain_destroy_caches(&caches[0], &caches[1]);
-        }
     } else {
         zend_error(E_WARNING, "invalid options passed to explain (%lu), please see documentation", options);
-        RETURN_FALSE;
+        return NULL;
     }
 
+    explain_snapshot_settle(snapshot);
+
     if (!ops) {
-        explain_destroy_caches(&caches[0], &caches[1]);
+        if (options & EXPLAIN_ISOLATE) {
+            explain_rollback(snapshot);
+        }
         zend_error(E_WARNING, "explain was unable to compile code");
-        RETURN_FALSE;
     }
 
-    explain_op_array(ops, &res);
+    return ops;
+} /* }}} */
 
-    if (ZVAL_IS_NULL(&res)) {
-        explain_destroy_caches(&caches[0], &caches[1]);
-        zend_error(E_WARNING, "explain was unable to compile code");
-        RETURN_FALSE;
+/* {{{ types
+ *
+ * EXPLAIN_TYPES infers the set of types every CV, TMP and VAR may hold at
+ * each opline. The op_array is split into basic blocks on the jump kinds of
+ * the opcode table, and the type sets of CVs are propagated between blocks
+ * until nothing changes; TMPs and VARs take the union of their definitions.
+ *
+ * This is a may-analysis: a type set only ever grows, anything the analysis
+ * cannot follow (references, dynamic variables, include, extract, try and
+ * finally) is widened, so a set with a single type can be trusted.
+ */
+#define EXPLAIN_MAY_BE_UNDEF    (1<<0)
+#define EXPLAIN_MAY_BE_NULL     (1<<1)
+#define EXPLAIN_MAY_BE_FALSE    (1<<2)
+#define EXPLAIN_MAY_BE_TRUE     (1<<3)
+#define EXPLAIN_MAY_BE_LONG     (1<<4)
+#define EXPLAIN_MAY_BE_DOUBLE   (1<<5)
+#define EXPLAIN_MAY_BE_STRING   (1<<6)
+#define EXPLAIN_MAY_BE_ARRAY    (1<<7)
+#define EXPLAIN_MAY_BE_OBJECT   (1<<8)
+#define EXPLAIN_MAY_BE_RESOURCE (1<<9)
+#define EXPLAIN_MAY_BE_REF      (1<<10)
+
+#define EXPLAIN_MAY_BE_BOOL    (EXPLAIN_MAY_BE_FALSE|EXPLAIN_MAY_BE_TRUE)
+#define EXPLAIN_MAY_BE_NUMBER  (EXPLAIN_MAY_BE_LONG|EXPLAIN_MAY_BE_DOUBLE)
+#define EXPLAIN_MAY_BE_ANY     (EXPLAIN_MAY_BE_NULL|EXPLAIN_MAY_BE_BOOL|EXPLAIN_MAY_BE_NUMBER| \
+                                EXPLAIN_MAY_BE_STRING|EXPLAIN_MAY_BE_ARRAY|EXPLAIN_MAY_BE_OBJECT|EXPLAIN_MAY_BE_RESOURCE)
+
+typedef struct _explain_types_t {
+    zend_op_array *ops;
+    uint32_t  vars;
+    uint32_t  blocks;
+    uint32_t *block;     /* block of each opline */
+    uint32_t *start;     /* first opline of each block */
+    uint32_t *entry;     /* CV types on entry to each block, blocks * last_var */
+    zend_uchar *reached;
+    uint32_t *temps;     /* types of TMPs and VARs, by var number */
+    uint32_t *state;     /* CV types while walking a block */
+    uint32_t *operands;  /* op1, op2 and result types of each opline */
+    zend_bool changed;
+} explain_types_t;
+
+static const struct {
+    uint32_t    type;
+    const char *name;
+    size_t      name_len;
+} explain_type_names[] = {
+    {EXPLAIN_MAY_BE_UNDEF,    "undef",    sizeof("undef") - 1},
+    {EXPLAIN_MAY_BE_NULL,     "null",     sizeof("null") - 1},
+    {EXPLAIN_MAY_BE_BOOL,     "bool",     sizeof("bool") - 1},
+    {EXPLAIN_MAY_BE_FALSE,    "false",    sizeof("false") - 1},
+    {EXPLAIN_MAY_BE_TRUE,     "true",     sizeof("true") - 1},
+    {EXPLAIN_MAY_BE_LONG,     "long",     sizeof("long") - 1},
+    {EXPLAIN_MAY_BE_DOUBLE,   "double",   sizeof("double") - 1},
+    {EXPLAIN_MAY_BE_STRING,   "string",   sizeof("string") - 1},
+    {EXPLAIN_MAY_BE_ARRAY,    "array",    sizeof("array") - 1},
+    {EXPLAIN_MAY_BE_OBJECT,   "object",   sizeof("object") - 1},
+    {EXPLAIN_MAY_BE_RESOURCE, "resource", sizeof("resource") - 1},
+    {EXPLAIN_MAY_BE_REF,      "ref",      sizeof("ref") - 1},
+    {0, NULL, 0}
+};
+
+static zend_string* explain_types_name(uint32_t types) { /* {{{ */
+    smart_str name = {0};
+    uint32_t it;
+
+    if ((types & EXPLAIN_MAY_BE_ANY) == EXPLAIN_MAY_BE_ANY) {
+        smart_str_appendl(&name, "any", sizeof("any") - 1);
+        types &= ~EXPLAIN_MAY_BE_ANY;
     }
 
-    if (classes) {
-        zend_ulong pce_num_key;
-        zend_string *pce_name;
-        zend_class_entry *pce;
+    for (it = 0; explain_type_names[it].name; it++) {
+        if ((types & explain_type_names[it].type) == explain_type_names[it].type) {
+            if (name.s) {
+                smart_str_appendc(&name, '|');
+            }
+            smart_str_appendl(&name, explain_type_names[it].name, explain_type_names[it].name_len);
 
-        if (Z_TYPE_P(classes) != IS_ARRAY) {
-            array_init(classes);
+            types &= ~explain_type_names[it].type;
         }
+    }
 
-        ZEND_HASH_FOREACH_KEY_VAL(CG(class_table), pce_num_key, pce_name, pce)
-        {
-            if (pce->type == ZEND_USER_CLASS && !zend_hash_exists(&caches[0], pce_name)) {
-                zval zce;
-                zend_function *pfe;
+    smart_str_0(&name);
 
-                array_init(&zce);
+    return name.s;
+} /* }}} */
 
-                ZEND_HASH_FOREACH_PTR(&pce->function_table, pfe) {
-                    if (pfe->common.type == ZEND_USER_FUNCTION) {
-                        zval zfe;
+static inline zend_bool explain_types_narrow(uint32_t types) { /* {{{ */
+    if (types & EXPLAIN_MAY_BE_REF) {
+        return 0;
+    }
 
-                        array_init(&zfe);
-                        explain_op_array(&pfe->op_array, &zfe);
+    /* reading undef is reading null, false|true is one type to the engine */
+    if (types & EXPLAIN_MAY_BE_UNDEF) {
+        types = (types & ~EXPLAIN_MAY_BE_UNDEF) | EXPLAIN_MAY_BE_NULL;
+    }
 
-                        add_assoc_zval_ex(&zce, pfe->common.function_name, strlen(pfe->common.function_name), &zfe);
-                    }
-                } ZEND_HASH_FOREACH_END();
+    if (types & EXPLAIN_MAY_BE_BOOL) {
+        types = (types & ~EXPLAIN_MAY_BE_BOOL) | EXPLAIN_MAY_BE_FALSE;
+    }
 
-                add_assoc_zval_ex(classes, pce->name, strlen(pce->name), &zce);
-            }
+    return !(types & (types - 1));
+} /* }}} */
 
-        }ZEND_HASH_FOREACH_END();
+static inline uint32_t explain_types_zval(zval *value) { /* {{{ */
+    switch (Z_TYPE_P(value)) {
+        case IS_NULL:   return EXPLAIN_MAY_BE_NULL;
+        case IS_FALSE:  return EXPLAIN_MAY_BE_FALSE;
+        case IS_TRUE:   return EXPLAIN_MAY_BE_TRUE;
+        case IS_LONG:   return EXPLAIN_MAY_BE_LONG;
+        case IS_DOUBLE: return EXPLAIN_MAY_BE_DOUBLE;
+        case IS_STRING: return EXPLAIN_MAY_BE_STRING;
+        case IS_ARRAY:  return EXPLAIN_MAY_BE_ARRAY;
     }
 
-    if (functions) {
-        zend_ulong pfe_num_key;
-        zend_function *pfe;
-        zend_string *fe_name;
+    /* constants and constant expressions are resolved at runtime */
+    return EXPLAIN_MAY_BE_ANY;
+} /* }}} */
 
-        if (Z_TYPE_P(functions) != IS_ARRAY) {
-            array_init(functions);
+static inline uint32_t explain_types_hint(zend_op_array *ops, uint32_t arg) { /* {{{ */
+    zend_arg_info *info;
+    uint32_t types, ref;
+    zend_uchar code;
+    zend_bool nullable;
+
+    if (!ops->arg_info) {
+        return EXPLAIN_MAY_BE_ANY;
+    }
+
+    if (arg >= ops->num_args) {
+        if (!(ops->fn_flags & ZEND_ACC_VARIADIC)) {
+            return EXPLAIN_MAY_BE_ANY;
         }
+        arg = ops->num_args;
+    }
 
-        ZEND_HASH_FOREACH_KEY_VAL(CG(function_table), pfe_num_key, fe_name, pfe) {
-            if (pfe->common.type == ZEND_USER_FUNCTION && !zend_hash_exists(&caches[1], fe_name)) {
-                zval zfe;
+    info = &ops->arg_info[arg];
 
-                array_init(&zfe);
-                explain_op_array(&pfe->op_array, &zfe);
+    /* typed or not, a parameter taken by reference is a reference */
+    ref = info->pass_by_reference ? EXPLAIN_MAY_BE_REF : 0;
 
-                add_assoc_zval_ex(functions, fe_name, strlen(fe_name), &zfe);
-            }
-        } ZEND_HASH_FOREACH_END();
+#if PHP_VERSION_ID >= 70200
+    code = ZEND_TYPE_IS_CLASS(info->type) ? IS_OBJECT : ZEND_TYPE_CODE(info->type);
+    nullable = ZEND_TYPE_ALLOW_NULL(info->type);
+#else
+    code = info->class_name ? IS_OBJECT : info->type_hint;
+    nullable = info->allow_null;
+#endif
+
+    switch (code) {
+        case IS_LONG:   types = EXPLAIN_MAY_BE_LONG; break;
+        /* weak mode converts integers passed as floats */
+        case IS_DOUBLE: types = EXPLAIN_MAY_BE_DOUBLE; break;
+        case _IS_BOOL:  types = EXPLAIN_MAY_BE_BOOL; break;
+        case IS_STRING: types = EXPLAIN_MAY_BE_STRING; break;
+        case IS_ARRAY:  types = EXPLAIN_MAY_BE_ARRAY; break;
+        case IS_OBJECT: types = EXPLAIN_MAY_BE_OBJECT; break;
+        case IS_CALLABLE:
+            types = EXPLAIN_MAY_BE_STRING|EXPLAIN_MAY_BE_ARRAY|EXPLAIN_MAY_BE_OBJECT;
+            break;
+#ifdef IS_ITERABLE
+        case IS_ITERABLE:
+            types = EXPLAIN_MAY_BE_ARRAY|EXPLAIN_MAY_BE_OBJECT;
+            break;
+#endif
+        default:
+            return EXPLAIN_MAY_BE_ANY | ref;
     }
 
-    explain_destroy_caches(&caches[0], &caches[1]);
+    if (nullable) {
+        types |= EXPLAIN_MAY_BE_NULL;
+    }
 
-    RETURN_ZVAL(&res, 0, 0);
+    return types | ref;
+} /* }}} */
 
-}
-/* }}} */
+static inline uint32_t explain_types_get(explain_types_t *t, znode_op *op, zend_uchar type) { /* {{{ */
+    uint32_t var;
 
-/* {{{ proto string explain_opcode(integer opcode)
-    get the friendly name for an opcode */
-PHP_FUNCTION(explain_opcode) {
-    long opcode;
+    switch (type) {
+        case IS_CONST:
+            return explain_types_zval(RT_CONSTANT_EX(t->ops->literals, *op));
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "l", &opcode) == FAILURE) {
-        return;
+        case IS_CV:
+            return t->state[EX_VAR_TO_NUM(op->var)];
+
+        case IS_TMP_VAR:
+        case IS_VAR:
+            var = EX_VAR_TO_NUM(op->var);
+
+            return var < t->vars ? t->temps[var - t->ops->last_var] : EXPLAIN_MAY_BE_ANY;
     }
 
-    explain_opcode(opcode, return_value);
+    return 0;
 } /* }}} */
 
-/* {{{ proto string explain_optype(integer optype)
-    get the friendly name for an optype */
-PHP_FUNCTION(explain_optype) {
-    long optype;
+static inline void explain_types_set(explain_types_t *t, znode_op *op, zend_uchar type, uint32_t types) { /* {{{ */
+    uint32_t var;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "l", &optype) == FAILURE) {
-        return;
-    }
+    switch (type) {
+        case IS_CV:
+            t->state[EX_VAR_TO_NUM(op->var)] = types;
+            break;
 
-    explain_optype((zend_uchar)optype, return_value);
+        case IS_TMP_VAR:
+        case IS_VAR:
+            var = EX_VAR_TO_NUM(op->var);
+
+            if (var < t->vars && (t->temps[var - t->ops->last_var] | types) != t->temps[var - t->ops->last_var]) {
+                t->temps[var - t->ops->last_var] |= types;
+                t->changed = 1;
+            }
+            break;
+    }
 } /* }}} */
 
-/* {{{ */
-static inline void php_explain_globals_ctor(zend_explain_globals *eg) {} /* }}} */
+static inline void explain_types_clobber(explain_types_t *t) { /* {{{ */
+    uint32_t var;
 
-static inline void php_explain_destroy_ops(zend_op_array **ops) { /* {{{ */
-    if ((*ops)) {
-        destroy_op_array(*ops);
-        efree(*ops);
+    for (var = 0; var < (uint32_t) t->ops->last_var; var++) {
+        t->state[var] |= EXPLAIN_MAY_BE_ANY|EXPLAIN_MAY_BE_REF;
     }
 } /* }}} */
 
-/* {{{ PHP_MINIT_FUNCTION
- */
-PHP_MINIT_FUNCTION(explain)
-{
-    ZEND_INIT_MODULE_GLOBALS(explain, php_explain_globals_ctor, NULL);
+static inline uint32_t explain_types_arithmetic(zend_uchar opcode, uint32_t t1, uint32_t t2) { /* {{{ */
+    uint32_t numbers = EXPLAIN_MAY_BE_ANY & ~EXPLAIN_MAY_BE_ARRAY;
 
-    REGISTER_LONG_CONSTANT("EXPLAIN_STRING",          EXPLAIN_STRING,      CONST_CS | CONST_PERSISTENT);
-    REGISTER_LONG_CONSTANT("EXPLAIN_FILE",            EXPLAIN_FILE,        CONST_CS | CONST_PERSISTENT);
-    REGISTER_LONG_CONSTANT("EXPLAIN_OPLINE",          EXPLAIN_OPLINE,      CONST_CS | CONST_PERSISTENT);
+    t1 &= EXPLAIN_MAY_BE_ANY;
+    t2 &= EXPLAIN_MAY_BE_ANY;
 
-    REGISTER_LONG_CONSTANT("EXPLAIN_IS_UNUSED",       IS_UNUSED,           CONST_CS | CONST_PERSISTENT);
-    REGISTER_LONG_CONSTANT("EXPLAIN_IS_VAR",          IS_VAR,              CONST_CS | CONST_PERSISTENT);
-    REGISTER_LONG_CONSTANT("EXPLAIN_IS_TMP_VAR",      IS_TMP_VAR,          CONST_CS | CONST_PERSISTENT);
-    REGISTER_LONG_CONSTANT("EXPLAIN_IS_CV",           IS_CV,               CONST_CS | CONST_PERSISTENT);
-#ifdef EXT_TYPE_UNUSED
-    REGISTER_LONG_CONSTANT("EXPLAIN_EXT_TYPE_UNUSED", EXT_TYPE_UNUSED,     CONST_CS | CONST_PERSISTENT);
-#endif
+    switch (opcode) {
+        case ZEND_ADD:
+            if (t1 == EXPLAIN_MAY_BE_ARRAY && t2 == EXPLAIN_MAY_BE_ARRAY) {
+                return EXPLAIN_MAY_BE_ARRAY;
+            }
+            /* break intentionally omitted */
 
-	return SUCCESS;
-}
-/* }}} */
+        case ZEND_SUB:
+        case ZEND_MUL:
+            if ((t1 == EXPLAIN_MAY_BE_DOUBLE && !(t2 & numbers & ~EXPLAIN_MAY_BE_NUMBER)) ||
+                (t2 == EXPLAIN_MAY_BE_DOUBLE && !(t1 & numbers & ~EXPLAIN_MAY_BE_NUMBER))) {
+                return EXPLAIN_MAY_BE_DOUBLE | (((t1 | t2) & EXPLAIN_MAY_BE_ARRAY) && opcode == ZEND_ADD ? EXPLAIN_MAY_BE_ARRAY : 0);
+            }
+            return EXPLAIN_MAY_BE_NUMBER | (((t1 & t2) & EXPLAIN_MAY_BE_ARRAY) && opcode == ZEND_ADD ? EXPLAIN_MAY_BE_ARRAY : 0);
 
-/* {{{ PHP_MSHUTDOWN_FUNCTION
- */
-PHP_MSHUTDOWN_FUNCTION(explain)
-{
-	/* uncomment this line if you have INI entries
-	UNREGISTER_INI_ENTRIES();
-	*/
-	return SUCCESS;
-}
-/* }}} */
+        case ZEND_MOD:
+        case ZEND_SL:
+        case ZEND_SR:
+            return EXPLAIN_MAY_BE_LONG;
 
-/* Remove if there's nothing to do at request start */
-/* {{{ PHP_RINIT_FUNCTION
- */
-PHP_RINIT_FUNCTION(explain)
-{
-#if defined(COMPILE_DL_EXPLAIN) && defined(ZTS)
-	ZEND_TSRMLS_CACHE_UPDATE();
-#endif
+        case ZEND_BW_OR:
+        case ZEND_BW_AND:
+        case ZEND_BW_XOR:
+            if (t1 == EXPLAIN_MAY_BE_STRING && t2 == EXPLAIN_MAY_BE_STRING) {
+                return EXPLAIN_MAY_BE_STRING;
+            }
+            return EXPLAIN_MAY_BE_LONG | ((t1 & t2 & EXPLAIN_MAY_BE_STRING) ? EXPLAIN_MAY_BE_STRING : 0);
 
-    zend_hash_init(&EX_G(explained), 8, NULL, (dtor_func_t) php_explain_destroy_ops, 0);
-    zend_hash_init(&EX_G(zval_cache), 8, NULL, (dtor_func_t) ZVAL_PTR_DTOR, 0);
+        case ZEND_CONCAT:
+            return EXPLAIN_MAY_BE_STRING;
+    }
 
-	return SUCCESS;
-}
-/* }}} */
+    /* DIV and POW */
+    return EXPLAIN_MAY_BE_NUMBER;
+} /* }}} */
 
-/* Remove if there's nothing to do at request end */
-/* {{{ PHP_RSHUTDOWN_FUNCTION
- */
-PHP_RSHUTDOWN_FUNCTION(explain)
-{
-    zend_hash_destroy(&EX_G(explained));
-    zend_hash_destroy(&EX_G(zval_cache));
+static inline uint32_t explain_types_step(uint32_t types, zend_bool increment) { /* {{{ */
+    uint32_t result = types & (EXPLAIN_MAY_BE_ANY & ~(EXPLAIN_MAY_BE_NULL|EXPLAIN_MAY_BE_LONG|EXPLAIN_MAY_BE_STRING));
 
-	return SUCCESS;
-}
-/* }}} */
+    if (types & (EXPLAIN_MAY_BE_UNDEF|EXPLAIN_MAY_BE_NULL)) {
+        /* ++null is 1, --null is null */
+        result |= increment ? EXPLAIN_MAY_BE_LONG : EXPLAIN_MAY_BE_NULL;
+    }
 
-/* {{{ PHP_MINFO_FUNCTION
- */
-PHP_MINFO_FUNCTION(explain)
-{
-	php_info_print_table_start();
+    if (types & EXPLAIN_MAY_BE_LONG) {
+        result |= EXPLAIN_MAY_BE_NUMBER;
+    }
+
+    if (types & EXPLAIN_MAY_BE_STRING) {
+        result |= EXPLAIN_MAY_BE_STRING|EXPLAIN_MAY_BE_NUMBER;
+    }
+
+    return result | (types & EXPLAIN_MAY_BE_REF);
+} /* }}} */
+
+static inline zend_uchar explain_types_compound(zend_op *opline) { /* {{{ */
+    switch (opline->opcode) {
+        case ZEND_ASSIGN_ADD:    return opline->extended_value ? 0 : ZEND_ADD;
+        case ZEND_ASSIGN_SUB:    return opline->extended_value ? 0 : ZEND_SUB;
+        case ZEND_ASSIGN_MUL:    return opline->extended_value ? 0 : ZEND_MUL;
+        case ZEND_ASSIGN_DIV:    return opline->extended_value ? 0 : ZEND_DIV;
+        case ZEND_ASSIGN_MOD:    return opline->extended_value ? 0 : ZEND_MOD;
+        case ZEND_ASSIGN_SL:     return opline->extended_value ? 0 : ZEND_SL;
+        case ZEND_ASSIGN_SR:     return opline->extended_value ? 0 : ZEND_SR;
+        case ZEND_ASSIGN_CONCAT: return opline->extended_value ? 0 : ZEND_CONCAT;
+        case ZEND_ASSIGN_BW_OR:  return opline->extended_value ? 0 : ZEND_BW_OR;
+        case ZEND_ASSIGN_BW_AND: return opline->extended_value ? 0 : ZEND_BW_AND;
+        case ZEND_ASSIGN_BW_XOR: return opline->extended_value ? 0 : ZEND_BW_XOR;
+        case ZEND_ASSIGN_POW:    return opline->extended_value ? 0 : ZEND_POW;
+    }
+
+    return 0;
+} /* }}} */
+
+static inline void explain_types_container(explain_types_t *t, zend_op *opline, uint32_t t1, uint32_t container) { /* {{{ */
+    /* writing a dimension or property of null creates the container */
+    if (opline->op1_type == IS_CV && (t1 & (EXPLAIN_MAY_BE_UNDEF|EXPLAIN_MAY_BE_NULL|EXPLAIN_MAY_BE_FALSE))) {
+        explain_types_set(t, &opline->op1, IS_CV,
+            (t1 & ~(EXPLAIN_MAY_BE_UNDEF|EXPLAIN_MAY_BE_NULL|EXPLAIN_MAY_BE_FALSE)) | container);
+    }
+} /* }}} */
+
+static void explain_types_opline(explain_types_t *t, zend_op *opline) { /* {{{ */
+    uint32_t t1 = explain_types_get(t, &opline->op1, opline->op1_type),
+             t2 = explain_types_get(t, &opline->op2, opline->op2_type),
+             result;
+    zend_uchar compound;
+
+    switch (opline->opcode) {
+        case ZEND_ADD:
+        case ZEND_SUB:
+        case ZEND_MUL:
+        case ZEND_DIV:
+        case ZEND_MOD:
+        case ZEND_SL:
+        case ZEND_SR:
+        case ZEND_POW:
+        case ZEND_BW_OR:
+        case ZEND_BW_AND:
+        case ZEND_BW_XOR:
+            result = explain_types_arithmetic(opline->opcode, t1, t2);
+            break;
+
+        case ZEND_CONCAT:
+        case ZEND_FAST_CONCAT:
+        case ZEND_ROPE_END:
+            result = EXPLAIN_MAY_BE_STRING;
+            break;
+
+        case ZEND_BW_NOT:
+            result = EXPLAIN_MAY_BE_LONG | (t1 & EXPLAIN_MAY_BE_STRING);
+            break;
+
+        case ZEND_BOOL:
+        case ZEND_BOOL_NOT:
+        case ZEND_BOOL_XOR:
+        case ZEND_IS_IDENTICAL:
+        case ZEND_IS_NOT_IDENTICAL:
+        case ZEND_IS_EQUAL:
+        case ZEND_IS_NOT_EQUAL:
+        case ZEND_IS_SMALLER:
+        case ZEND_IS_SMALLER_OR_EQUAL:
+        case ZEND_CASE:
+        case ZEND_JMPZ_EX:
+        case ZEND_JMPNZ_EX:
+        case ZEND_INSTANCEOF:
+        case ZEND_TYPE_CHECK:
+        case ZEND_DEFINED:
+        case ZEND_ISSET_ISEMPTY_VAR:
+        case ZEND_ISSET_ISEMPTY_DIM_OBJ:
+        case ZEND_ISSET_ISEMPTY_PROP_OBJ:
+        case ZEND_ISSET_ISEMPTY_STATIC_PROP:
+            result = EXPLAIN_MAY_BE_BOOL;
+            break;
+
+        case ZEND_CAST:
+            switch (opline->extended_value) {
+                case IS_NULL:   result = EXPLAIN_MAY_BE_NULL; break;
+                case _IS_BOOL:  result = EXPLAIN_MAY_BE_BOOL; break;
+                case IS_LONG:   result = EXPLAIN_MAY_BE_LONG; break;
+                case IS_DOUBLE: result = EXPLAIN_MAY_BE_DOUBLE; break;
+                case IS_STRING: result = EXPLAIN_MAY_BE_STRING; break;
+                case IS_ARRAY:  result = EXPLAIN_MAY_BE_ARRAY; break;
+                case IS_OBJECT: result = EXPLAIN_MAY_BE_OBJECT; break;
+                default:        result = EXPLAIN_MAY_BE_ANY;
+            }
+            break;
+
+        case ZEND_QM_ASSIGN:
+        case ZEND_JMP_SET:
+#ifdef ZEND_COALESCE
+        case ZEND_COALESCE:
+#endif
+            result = t1 & EXPLAIN_MAY_BE_ANY;
+            if (t1 & EXPLAIN_MAY_BE_UNDEF) {
+                result |= EXPLAIN_MAY_BE_NULL;
+            }
+            break;
+
+        case ZEND_INIT_ARRAY:
+        case ZEND_ADD_ARRAY_ELEMENT:
+            result = EXPLAIN_MAY_BE_ARRAY;
+            break;
+
+        case ZEND_NEW:
+        case ZEND_CLONE:
+        case ZEND_DECLARE_LAMBDA_FUNCTION:
+            result = EXPLAIN_MAY_BE_OBJECT;
+            break;
+
+        case ZEND_ASSIGN:
+            result = t2 & EXPLAIN_MAY_BE_ANY;
+            if (t2 & EXPLAIN_MAY_BE_UNDEF) {
+                result |= EXPLAIN_MAY_BE_NULL;
+            }
+
+            if (opline->op1_type == IS_CV) {
+                /* assigning to a reference leaves it a reference */
+                explain_types_set(t, &opline->op1, IS_CV, result | (t1 & EXPLAIN_MAY_BE_REF));
+            }
+            break;
+
+        case ZEND_PRE_INC:
+        case ZEND_PRE_DEC:
+            result = explain_types_step(t1, opline->opcode == ZEND_PRE_INC);
+            if (opline->op1_type == IS_CV) {
+                explain_types_set(t, &opline->op1, IS_CV, result);
+            }
+            result &= EXPLAIN_MAY_BE_ANY;
+            break;
+
+        case ZEND_POST_INC:
+        case ZEND_POST_DEC:
+            if (opline->op1_type == IS_CV) {
+                explain_types_set(t, &opline->op1, IS_CV, explain_types_step(t1, opline->opcode == ZEND_POST_INC));
+            }
+            result = (t1 & EXPLAIN_MAY_BE_ANY) | ((t1 & EXPLAIN_MAY_BE_UNDEF) ? EXPLAIN_MAY_BE_NULL : 0);
+            break;
+
+        case ZEND_RECV:
+        case ZEND_RECV_INIT:
+#ifdef ZEND_RECV_VARIADIC
+        case ZEND_RECV_VARIADIC:
+#endif
+            result = explain_types_hint(t->ops, opline->op1.num - 1);
+
+            if (opline->opcode == ZEND_RECV_INIT) {
+                result |= explain_types_zval(RT_CONSTANT_EX(t->ops->literals, opline->op2));
+            }
+#ifdef ZEND_RECV_VARIADIC
+            if (opline->opcode == ZEND_RECV_VARIADIC) {
+                result = EXPLAIN_MAY_BE_ARRAY;
+            }
+#endif
+            break;
+
+        case ZEND_ASSIGN_REF:
+            if (opline->op2_type == IS_CV) {
+                explain_types_set(t, &opline->op2, IS_CV, t2 | EXPLAIN_MAY_BE_ANY | EXPLAIN_MAY_BE_REF);
+            }
+            /* break intentionally omitted */
+
+        case ZEND_BIND_GLOBAL:
+        case ZEND_BIND_STATIC:
+        case ZEND_SEND_REF:
+        case ZEND_SEND_VAR_EX:
+        case ZEND_FE_RESET_RW:
+#ifdef ZEND_MAKE_REF
+        case ZEND_MAKE_REF:
+#endif
+            if (opline->op1_type == IS_CV) {
+                explain_types_set(t, &opline->op1, IS_CV, t1 | EXPLAIN_MAY_BE_ANY | EXPLAIN_MAY_BE_REF);
+            }
+            result = EXPLAIN_MAY_BE_ANY | EXPLAIN_MAY_BE_REF;
+            break;
+
+        case ZEND_FE_FETCH_R:
+        case ZEND_FE_FETCH_RW:
+            if (opline->op2_type == IS_CV) {
+                explain_types_set(t, &opline->op2, IS_CV, EXPLAIN_MAY_BE_ANY |
+                    (opline->opcode == ZEND_FE_FETCH_RW ? EXPLAIN_MAY_BE_REF : (t2 & EXPLAIN_MAY_BE_REF)));
+            }
+            result = EXPLAIN_MAY_BE_ANY;
+            break;
+
+        case ZEND_CATCH:
+            if (opline->op2_type == IS_CV) {
+                explain_types_set(t, &opline->op2, IS_CV, EXPLAIN_MAY_BE_OBJECT);
+            }
+            result = EXPLAIN_MAY_BE_OBJECT;
+            break;
+
+        case ZEND_ASSIGN_DIM:
+        case ZEND_FETCH_DIM_W:
+        case ZEND_FETCH_DIM_RW:
+            explain_types_container(t, opline, t1, EXPLAIN_MAY_BE_ARRAY);
+            result = EXPLAIN_MAY_BE_ANY;
+            break;
+
+        case ZEND_ASSIGN_OBJ:
+        case ZEND_FETCH_OBJ_W:
+        case ZEND_FETCH_OBJ_RW:
+            explain_types_container(t, opline, t1, EXPLAIN_MAY_BE_OBJECT);
+            result = EXPLAIN_MAY_BE_ANY;
+            break;
+
+#ifdef ZEND_UNSET_CV
+        case ZEND_UNSET_CV:
+            explain_types_set(t, &opline->op1, IS_CV, EXPLAIN_MAY_BE_UNDEF);
+            result = 0;
+            break;
+#endif
+
+        case ZEND_UNSET_VAR:
+            if (opline->op1_type == IS_CV) {
+                explain_types_set(t, &opline->op1, IS_CV, EXPLAIN_MAY_BE_UNDEF);
+            } else explain_types_clobber(t);
+            result = 0;
+            break;
+
+        case ZEND_FETCH_W:
+        case ZEND_FETCH_RW:
+        case ZEND_FETCH_UNSET:
+        case ZEND_INCLUDE_OR_EVAL:
+            /* variable variables and included code reach every CV */
+            if (opline->opcode == ZEND_INCLUDE_OR_EVAL || opline->op1_type != IS_CONST) {
+                explain_types_clobber(t);
+            }
+            result = EXPLAIN_MAY_BE_ANY | EXPLAIN_MAY_BE_REF;
+            break;
+
+        case ZEND_INIT_FCALL:
+        case ZEND_INIT_FCALL_BY_NAME:
+            if (opline->op2_type == IS_CONST) {
+                zval *name = RT_CONSTANT_EX(t->ops->literals, opline->op2);
+
+                if (Z_TYPE_P(name) == IS_STRING &&
+                    (zend_binary_strcasecmp(Z_STRVAL_P(name), Z_STRLEN_P(name), "extract", sizeof("extract") - 1) == 0 ||
+                     zend_binary_strcasecmp(Z_STRVAL_P(name), Z_STRLEN_P(name), "parse_str", sizeof("parse_str") - 1) == 0)) {
+                    explain_types_clobber(t);
+                }
+            }
+            result = 0;
+            break;
+
+        default:
+            if ((compound = explain_types_compound(opline))) {
+                result = explain_types_arithmetic(compound, t1, t2);
+
+                if (opline->op1_type == IS_CV) {
+                    explain_types_set(t, &opline->op1, IS_CV, result | (t1 & EXPLAIN_MAY_BE_REF));
+                }
+                break;
+            }
+            /* compound assignment to a dimension or property */
+            if ((opline->opcode >= ZEND_ASSIGN_ADD && opline->opcode <= ZEND_ASSIGN_BW_XOR) || opline->opcode == ZEND_ASSIGN_POW) {
+                explain_types_container(t, opline, t1,
+                    opline->extended_value == ZEND_ASSIGN_DIM ? EXPLAIN_MAY_BE_ARRAY : EXPLAIN_MAY_BE_OBJECT);
+            }
+            result = EXPLAIN_MAY_BE_ANY;
+    }
+
+    if (opline->result_type & (IS_TMP_VAR|IS_VAR|IS_CV)) {
+        explain_types_set(t, &opline->result, opline->result_type, result);
+    }
+} /* }}} */
+
+static inline zend_bool explain_types_terminates(zend_uchar opcode) { /* {{{ */
+    switch (opcode) {
+        case ZEND_JMP:
+        case ZEND_RETURN:
+        case ZEND_RETURN_BY_REF:
+        case ZEND_THROW:
+        case ZEND_EXIT:
+#ifdef ZEND_GENERATOR_RETURN
+        case ZEND_GENERATOR_RETURN:
+#endif
+#ifdef ZEND_FAST_RET
+        case ZEND_FAST_RET:
+#endif
+#ifdef ZEND_GOTO
+        case ZEND_GOTO:
+#endif
+            return 1;
+    }
+
+    return 0;
+} /* }}} */
+
+static inline void explain_types_flow(explain_types_t *t, int32_t to) { /* {{{ */
+    uint32_t block, var, *entry;
+
+    if (to < 0 || (uint32_t) to >= t->ops->last) {
+        return;
+    }
+
+    block = t->block[to];
+    entry = &t->entry[(size_t) block * t->ops->last_var];
+
+    if (!t->reached[block]) {
+        t->reached[block] = 1;
+        t->changed = 1;
+    }
+
+    for (var = 0; var < (uint32_t) t->ops->last_var; var++) {
+        if ((entry[var] | t->state[var]) != entry[var]) {
+            entry[var] |= t->state[var];
+            t->changed = 1;
+        }
+    }
+} /* }}} */
+
+static void explain_types_block(explain_types_t *t, uint32_t block, zend_bool record) { /* {{{ */
+    uint32_t next = t->start[block],
+             end = block + 1 < t->blocks ? t->start[block + 1] : t->ops->last;
+
+    memcpy(t->state, &t->entry[(size_t) block * t->ops->last_var], t->ops->last_var * sizeof(uint32_t));
+
+    for (; next < end; next++) {
+        zend_op *opline = &t->ops->opcodes[next];
+
+        if (record) {
+            t->operands[next * 3]     = explain_types_get(t, &opline->op1, opline->op1_type);
+            t->operands[next * 3 + 1] = explain_types_get(t, &opline->op2, opline->op2_type);
+        }
+
+        explain_types_opline(t, opline);
+
+        if (record) {
+            t->operands[next * 3 + 2] = explain_types_get(t, &opline->result, opline->result_type);
+        }
+    }
+
+    if (record) {
+        return;
+    }
+
+    next = end - 1;
+
+    {
+        zend_op *opline = &t->ops->opcodes[next];
+        const explain_opcode_t *decode = explain_opcode_decode(opline->opcode);
+
+        if (decode && (decode->kind & EXPLAIN_OP1_OPLINE)) {
+            explain_types_flow(t, explain_jmp_line(t->ops, &opline->op1, next));
+        }
+
+        if (decode && (decode->kind & EXPLAIN_OP2_OPLINE)) {
+            explain_types_flow(t, explain_jmp_line(t->ops, &opline->op2, next));
+        }
+
+        if (decode && (decode->kind & EXPLAIN_EXT_OPLINE)) {
+            explain_types_flow(t, EXT_LINE(opline->extended_value, next));
+        }
+
+        if (!explain_types_terminates(opline->opcode)) {
+            explain_types_flow(t, end);
+        }
+    }
+} /* }}} */
+
+static void explain_types_analyse(explain_types_t *t) { /* {{{ */
+    zend_op_array *ops = t->ops;
+    zend_uchar *leader = ecalloc(ops->last + 1, 1);
+    zend_bool unknown = 0;
+    uint32_t next, block, var;
+    int it;
+
+    leader[0] = 1;
+
+    for (next = 0; next < ops->last; next++) {
+        zend_op *opline = &ops->opcodes[next];
+        const explain_opcode_t *decode = explain_opcode_decode(opline->opcode);
+        int32_t target;
+
+        if (decode && (decode->kind & (EXPLAIN_OP1_OPLINE|EXPLAIN_OP2_OPLINE|EXPLAIN_EXT_OPLINE))) {
+            leader[next + 1] = 1;
+
+            if (decode->kind & EXPLAIN_OP1_OPLINE) {
+                target = explain_jmp_line(ops, &opline->op1, next);
+                if (target >= 0 && (uint32_t) target < ops->last) leader[target] = 1;
+            }
+
+            if (decode->kind & EXPLAIN_OP2_OPLINE) {
+                target = explain_jmp_line(ops, &opline->op2, next);
+                if (target >= 0 && (uint32_t) target < ops->last) leader[target] = 1;
+            }
+
+            if (decode->kind & EXPLAIN_EXT_OPLINE) {
+                target = EXT_LINE(opline->extended_value, next);
+                if (target >= 0 && (uint32_t) target < ops->last) leader[target] = 1;
+            }
+        } else if (explain_types_terminates(opline->opcode)) {
+            leader[next + 1] = 1;
+        }
+
+        switch (opline->opcode) {
+#ifdef ZEND_SWITCH_LONG
+            case ZEND_SWITCH_LONG:
+            case ZEND_SWITCH_STRING:
+                unknown = 1;
+#endif
+        }
+    }
+
+    for (it = 0; it < ops->last_try_catch; it++) {
+        leader[ops->try_catch_array[it].catch_op] = 1;
+        if (ops->try_catch_array[it].finally_op) {
+            leader[ops->try_catch_array[it].finally_op] = 1;
+            leader[ops->try_catch_array[it].finally_end] = 1;
+        }
+    }
+
+    t->block = safe_emalloc(ops->last, sizeof(uint32_t), 0);
+    t->start = safe_emalloc(ops->last, sizeof(uint32_t), 0);
+
+    for (next = 0, t->blocks = 0; next < ops->last; next++) {
+        if (leader[next]) {
+            t->start[t->blocks++] = next;
+        }
+        t->block[next] = t->blocks - 1;
+    }
+
+    t->entry = safe_emalloc((size_t) t->blocks * ops->last_var + 1, sizeof(uint32_t), 0);
+    t->reached = ecalloc(t->blocks, 1);
+
+    /* CVs start undefined, every other block starts empty and is reached by flow */
+    for (var = 0; var < (uint32_t) ops->last_var; var++) {
+        t->entry[var] = EXPLAIN_MAY_BE_UNDEF;
+    }
+    memset(&t->entry[ops->last_var], 0, ((size_t) t->blocks - 1) * ops->last_var * sizeof(uint32_t));
+
+    t->reached[0] = 1;
+
+    /* exception handlers and finally are entered from anywhere, jump tables are not followed */
+    for (block = 1; block < t->blocks; block++) {
+        zend_bool handler = unknown;
+
+        for (it = 0; !handler && it < ops->last_try_catch; it++) {
+            handler = t->start[block] == ops->try_catch_array[it].catch_op ||
+                      t->start[block] == ops->try_catch_array[it].finally_op ||
+                      t->start[block] == ops->try_catch_array[it].finally_end;
+        }
+
+        if (handler) {
+            t->reached[block] = 1;
+
+            for (var = 0; var < (uint32_t) ops->last_var; var++) {
+                t->entry[(size_t) block * ops->last_var + var] = EXPLAIN_MAY_BE_ANY|EXPLAIN_MAY_BE_REF|EXPLAIN_MAY_BE_UNDEF;
+            }
+        }
+    }
+
+    efree(leader);
+
+    do {
+        t->changed = 0;
+
+        for (block = 0; block < t->blocks; block++) {
+            if (t->reached[block]) {
+                explain_types_block(t, block, 0);
+            }
+        }
+    } while (t->changed);
+
+    for (block = 0; block < t->blocks; block++) {
+        if (t->reached[block]) {
+            explain_types_block(t, block, 1);
+        }
+    }
+} /* }}} */
+
+static inline void explain_types_operand(zval *zopline, const char *name, size_t name_len, zend_uchar type, uint32_t types, zend_bool *narrow) { /* {{{ */
+    if (!(type & (IS_CV|IS_TMP_VAR|IS_VAR)) || !types) {
+        return;
+    }
+
+    add_assoc_str_ex(zopline, name, name_len, explain_types_name(types));
+
+    if (!explain_types_narrow(types)) {
+        *narrow = 0;
+    }
+} /* }}} */
+
+/* {{{ annotate the oplines explain_op_array() decoded from ops with their operand types,
+    the oplines with an operand that could not be narrowed to one type are added to unstable */
+static void explain_types_op_array(zend_op_array *ops, zval *decoded, zval *unstable) {
+    explain_types_t t;
+    uint32_t next;
+
+    if (!ops->last || Z_TYPE_P(decoded) != IS_ARRAY) {
+        return;
+    }
+
+    memset(&t, 0, sizeof(explain_types_t));
+
+    t.ops = ops;
+    t.vars = ops->last_var + ops->T;
+    t.temps = ecalloc(ops->T + 1, sizeof(uint32_t));
+    t.state = ecalloc(ops->last_var + 1, sizeof(uint32_t));
+    t.operands = ecalloc((size_t) ops->last * 3, sizeof(uint32_t));
+
+    explain_types_analyse(&t);
+
+    for (next = 0; next < ops->last; next++) {
+        zend_op *opline = &ops->opcodes[next];
+        const explain_opcode_t *decode = explain_opcode_decode(opline->opcode);
+        uint32_t kind = decode ? decode->kind : 0;
+        zval *zopline = zend_hash_index_find(Z_ARRVAL_P(decoded), next);
+        zend_bool narrow = 1;
+
+        if (!zopline || !t.reached[t.block[next]]) {
+            continue;
+        }
+
+        if (!(kind & (EXPLAIN_OP1_OPLINE|EXPLAIN_RESULT_ONLY))) {
+            explain_types_operand(zopline, "op1_types", sizeof("op1_types") - 1, opline->op1_type, t.operands[next * 3], &narrow);
+        }
+
+        if (!(kind & (EXPLAIN_OP2_OPLINE|EXPLAIN_RESULT_ONLY))) {
+            explain_types_operand(zopline, "op2_types", sizeof("op2_types") - 1, opline->op2_type, t.operands[next * 3 + 1], &narrow);
+        }
+
+        explain_types_operand(zopline, "result_types", sizeof("result_types") - 1, opline->result_type, t.operands[next * 3 + 2], &narrow);
+
+        if (!narrow && unstable) {
+            add_next_index_long(unstable, next);
+        }
+    }
+
+    efree(t.temps);
+    efree(t.state);
+    efree(t.operands);
+    efree(t.block);
+    efree(t.start);
+    efree(t.entry);
+    efree(t.reached);
+} /* }}} */
+/* }}} */
+
+/* {{{ with EXPLAIN_TYPES, annotate decoded and record its unstable oplines in types under
+    {main}, the function name or Class::method */
+static inline void explain_types(zend_op_array *ops, zend_ulong options, zval *decoded, zval *types) {
+    zval unstable;
+    zend_string *name;
+
+    if (!(options & EXPLAIN_TYPES)) {
+        return;
+    }
+
+    array_init(&unstable);
+
+    explain_types_op_array(ops, decoded, &unstable);
+
+    if (!types) {
+        zval_ptr_dtor(&unstable);
+        return;
+    }
+
+    name = explain_op_array_name(ops);
+
+    zend_symtable_update(Z_ARRVAL_P(types), name, &unstable);
+
+    zend_string_release(name);
+} /* }}} */
+
+/* {{{ loaded
+ *
+ * explain_function() and explain_class() decode op_arrays that are already
+ * in the function and class tables, nothing is compiled and nothing is
+ * declared, so there is no snapshot to take and nothing to roll back.
+ */
+static inline zend_class_entry* explain_loaded_class(const char *name, size_t name_len) { /* {{{ */
+    zend_string *key;
+    zend_class_entry *pce;
+
+    if (name_len && name[0] == '\\') {
+        name++;
+        name_len--;
+    }
+
+    key = zend_string_alloc(name_len, 0);
+    zend_str_tolower_copy(ZSTR_VAL(key), name, name_len);
+
+    /* only what is loaded, explaining must never trigger an autoloader */
+    pce = zend_hash_find_ptr(EG(class_table), key);
+
+    zend_string_release(key);
+
+    return pce;
+} /* }}} */
+
+static inline zend_function* explain_loaded_method(zend_class_entry *pce, const char *name, size_t name_len) { /* {{{ */
+    zend_string *key = zend_string_alloc(name_len, 0);
+    zend_function *pfe;
+
+    zend_str_tolower_copy(ZSTR_VAL(key), name, name_len);
+
+    pfe = zend_hash_find_ptr(&pce->function_table, key);
+
+    zend_string_release(key);
+
+    return pfe;
+} /* }}} */
+
+/* {{{ find the function a closure, "function", "Class::method" or array(class or object, "method") refers to */
+static zend_function* explain_loaded_function(zval *function) {
+    zend_class_entry *pce;
+    zend_function *pfe;
+    zend_string *key;
+    zval *scope, *method;
+    const char *sep;
+
+    switch (Z_TYPE_P(function)) {
+        case IS_OBJECT:
+            if (Z_OBJCE_P(function) != zend_ce_closure) {
+                return NULL;
+            }
+            return (zend_function*) zend_get_closure_method_def(function);
+
+        case IS_STRING:
+            sep = zend_memnstr(Z_STRVAL_P(function), "::", sizeof("::") - 1, Z_STRVAL_P(function) + Z_STRLEN_P(function));
+
+            if (sep) {
+                pce = explain_loaded_class(Z_STRVAL_P(function), sep - Z_STRVAL_P(function));
+
+                if (!pce) {
+                    return NULL;
+                }
+
+                sep += sizeof("::") - 1;
+
+                return explain_loaded_method(pce, sep, Z_STRVAL_P(function) + Z_STRLEN_P(function) - sep);
+            }
+
+            if (Z_STRLEN_P(function) && Z_STRVAL_P(function)[0] == '\\') {
+                key = zend_string_alloc(Z_STRLEN_P(function) - 1, 0);
+                zend_str_tolower_copy(ZSTR_VAL(key), Z_STRVAL_P(function) + 1, Z_STRLEN_P(function) - 1);
+            } else {
+                key = zend_string_tolower(Z_STR_P(function));
+            }
+
+            pfe = zend_hash_find_ptr(EG(function_table), key);
+
+            zend_string_release(key);
+
+            return pfe;
+
+        case IS_ARRAY:
+            if (zend_hash_num_elements(Z_ARRVAL_P(function)) != 2 ||
+                !(scope = zend_hash_index_find(Z_ARRVAL_P(function), 0)) ||
+                !(method = zend_hash_index_find(Z_ARRVAL_P(function), 1)) ||
+                Z_TYPE_P(method) != IS_STRING) {
+                return NULL;
+            }
+
+            if (Z_TYPE_P(scope) == IS_OBJECT) {
+                pce = Z_OBJCE_P(scope);
+            } else if (Z_TYPE_P(scope) == IS_STRING) {
+                pce = explain_loaded_class(Z_STRVAL_P(scope), Z_STRLEN_P(scope));
+            } else return NULL;
+
+            return pce ? explain_loaded_method(pce, Z_STRVAL_P(method), Z_STRLEN_P(method)) : NULL;
+    }
+
+    return NULL;
+} /* }}} */
+
+/* {{{ decode every user method of pce into zce, keyed by method name */
+static void explain_class_methods(zend_class_entry *pce, zend_ulong options, zval *zce, zval *types) {
+    zend_function *pfe;
+
+    array_init(zce);
+
+    ZEND_HASH_FOREACH_PTR(&pce->function_table, pfe) {
+        if (pfe->common.type == ZEND_USER_FUNCTION) {
+            zval zfe;
+
+            explain_op_array(&pfe->op_array, &zfe);
+            explain_types(&pfe->op_array, options, &zfe, types);
+
+            add_assoc_zval_ex(zce, ZSTR_VAL(pfe->common.function_name), ZSTR_LEN(pfe->common.function_name), &zfe);
+        }
+    } ZEND_HASH_FOREACH_END();
+} /* }}} */
+/* }}} */
+
+/* {{{ export
+ *
+ * explain_export() serializes oplines straight into a stream buffer,
+ * no zvals are allocated, the buffer is flushed every EXPLAIN_EXPORT_FLUSH
+ * bytes so memory stays flat however much code is exported.
+ */
+#define EXPLAIN_EXPORT_NDJSON  1
+#define EXPLAIN_EXPORT_MSGPACK 2
+
+#define EXPLAIN_EXPORT_OP_ARRAY 0x00000100
+
+#define EXPLAIN_EXPORT_FLUSH 8192
+
+#define EXPLAIN_EXPORT_FIELDS 16
+
+typedef struct _explain_export_t {
+    php_stream *stream;
+    smart_str   buf;
+    zend_long   format;
+    zend_long   options;
+    zend_string *file;
+    zend_long   records;
+} explain_export_t;
+
+typedef struct _explain_export_field_t {
+    const char *name;
+    size_t      name_len;
+    zval        value;
+} explain_export_field_t;
+
+/* temporaries are numbered in order of first use, ids holds that number + 1 */
+typedef struct _explain_export_temps_t {
+    uint32_t *ids;
+    uint32_t  next;
+} explain_export_temps_t;
+
+static inline void explain_export_be(explain_export_t *ex, unsigned char type, uint64_t value, int bytes) { /* {{{ */
+    unsigned char packed[9];
+    int i;
+
+    packed[0] = type;
+
+    for (i = bytes; i > 0; i--) {
+        packed[i] = (unsigned char) (value & 0xff);
+        value >>= 8;
+    }
+
+    smart_str_appendl(&ex->buf, (const char*) packed, bytes + 1);
+} /* }}} */
+
+static inline void explain_export_null(explain_export_t *ex) { /* {{{ */
+    if (ex->format == EXPLAIN_EXPORT_MSGPACK) {
+        smart_str_appendc(&ex->buf, 0xc0);
+    } else smart_str_appendl(&ex->buf, "null", sizeof("null") - 1);
+} /* }}} */
+
+static inline void explain_export_bool(explain_export_t *ex, zend_bool value) { /* {{{ */
+    if (ex->format == EXPLAIN_EXPORT_MSGPACK) {
+        smart_str_appendc(&ex->buf, value ? 0xc3 : 0xc2);
+    } else if (value) {
+        smart_str_appendl(&ex->buf, "true", sizeof("true") - 1);
+    } else smart_str_appendl(&ex->buf, "false", sizeof("false") - 1);
+} /* }}} */
+
+static inline void explain_export_long(explain_export_t *ex, zend_long value) { /* {{{ */
+    if (ex->format != EXPLAIN_EXPORT_MSGPACK) {
+        smart_str_append_long(&ex->buf, value);
+        return;
+    }
+
+    if (value >= 0) {
+        if (value < 0x80) {
+            smart_str_appendc(&ex->buf, (unsigned char) value);
+        } else if (value <= 0xff) {
+            explain_export_be(ex, 0xcc, value, 1);
+        } else if (value <= 0xffff) {
+            explain_export_be(ex, 0xcd, value, 2);
+        } else if ((zend_ulong) value <= 0xffffffff) {
+            explain_export_be(ex, 0xce, value, 4);
+        } else explain_export_be(ex, 0xcf, value, 8);
+    } else {
+        if (value >= -32) {
+            smart_str_appendc(&ex->buf, (unsigned char) (0xe0 | (value & 0x1f)));
+        } else if (value >= -128) {
+            explain_export_be(ex, 0xd0, (uint8_t) (int8_t) value, 1);
+        } else if (value >= -32768) {
+            explain_export_be(ex, 0xd1, (uint16_t) (int16_t) value, 2);
+        } else if (value >= INT32_MIN) {
+            explain_export_be(ex, 0xd2, (uint32_t) (int32_t) value, 4);
+        } else explain_export_be(ex, 0xd3, (uint64_t) (int64_t) value, 8);
+    }
+} /* }}} */
+
+static inline void explain_export_double(explain_export_t *ex, double value) { /* {{{ */
+    if (ex->format == EXPLAIN_EXPORT_MSGPACK) {
+        uint64_t bits;
+
+        memcpy(&bits, &value, sizeof(bits));
+        explain_export_be(ex, 0xcb, bits, 8);
+    } else if (zend_finite(value) && !zend_isnan(value)) {
+        char num[64];
+        size_t len;
+
+        /* %H ignores the locale, and follows serialize_precision like var_export() */
+        len = snprintf(num, sizeof(num) - 2, "%.*H", (int) PG(serialize_precision), value);
+
+        /* keep 1.0 a double for the reader */
+        if (!memchr(num, '.', len) && !memchr(num, 'E', len)) {
+            num[len++] = '.';
+            num[len++] = '0';
+        }
+
+        smart_str_appendl(&ex->buf, num, len);
+    } else explain_export_null(ex);
+} /* }}} */
+
+static inline void explain_export_string(explain_export_t *ex, const char *str, size_t len) { /* {{{ */
+    static const char hex[] = "0123456789abcdef";
+    size_t i;
+
+    if (ex->format == EXPLAIN_EXPORT_MSGPACK) {
+        if (len < 32) {
+            smart_str_appendc(&ex->buf, (unsigned char) (0xa0 | len));
+        } else if (len <= 0xff) {
+            explain_export_be(ex, 0xd9, len, 1);
+        } else if (len <= 0xffff) {
+            explain_export_be(ex, 0xda, len, 2);
+        } else explain_export_be(ex, 0xdb, len, 4);
+
+        smart_str_appendl(&ex->buf, str, len);
+        return;
+    }
+
+    smart_str_appendc(&ex->buf, '"');
+    for (i = 0; i < len;) {
+        unsigned char c = (unsigned char) str[i];
+
+        if (c >= 0x80) {
+            size_t start = i;
+            int status;
+
+            php_next_utf8_char((const unsigned char*) str, len, &i, &status);
+
+            if (i == start) {
+                i++;
+            }
+
+            /* binary and latin-1 literals would make the record undecodable */
+            if (status != SUCCESS) {
+                smart_str_appendl(&ex->buf, "\\ufffd", sizeof("\\ufffd") - 1);
+            } else smart_str_appendl(&ex->buf, str + start, i - start);
+            continue;
+        }
+
+        i++;
+
+        switch (c) {
+            case '"':  smart_str_appendl(&ex->buf, "\\\"", 2); break;
+            case '\\': smart_str_appendl(&ex->buf, "\\\\", 2); break;
+            case '\n': smart_str_appendl(&ex->buf, "\\n", 2);  break;
+            case '\r': smart_str_appendl(&ex->buf, "\\r", 2);  break;
+            case '\t': smart_str_appendl(&ex->buf, "\\t", 2);  break;
+
+            default: if (c < 0x20) {
+                smart_str_appendl(&ex->buf, "\\u00", 4);
+                smart_str_appendc(&ex->buf, hex[c >> 4]);
+                smart_str_appendc(&ex->buf, hex[c & 0xf]);
+            } else smart_str_appendc(&ex->buf, c);
+        }
+    }
+    smart_str_appendc(&ex->buf, '"');
+} /* }}} */
+
+static inline void explain_export_map(explain_export_t *ex, uint32_t size) { /* {{{ */
+    if (ex->format == EXPLAIN_EXPORT_MSGPACK) {
+        if (size < 16) {
+            smart_str_appendc(&ex->buf, (unsigned char) (0x80 | size));
+        } else if (size <= 0xffff) {
+            explain_export_be(ex, 0xde, size, 2);
+        } else explain_export_be(ex, 0xdf, size, 4);
+    } else smart_str_appendc(&ex->buf, '{');
+} /* }}} */
+
+static inline void explain_export_list(explain_export_t *ex, uint32_t size) { /* {{{ */
+    if (ex->format == EXPLAIN_EXPORT_MSGPACK) {
+        if (size < 16) {
+            smart_str_appendc(&ex->buf, (unsigned char) (0x90 | size));
+        } else if (size <= 0xffff) {
+            explain_export_be(ex, 0xdc, size, 2);
+        } else explain_export_be(ex, 0xdd, size, 4);
+    } else smart_str_appendc(&ex->buf, '[');
+} /* }}} */
+
+static inline void explain_export_end(explain_export_t *ex, char end) { /* {{{ */
+    if (ex->format != EXPLAIN_EXPORT_MSGPACK) {
+        smart_str_appendc(&ex->buf, end);
+    }
+} /* }}} */
+
+static inline void explain_export_next(explain_export_t *ex, uint32_t idx) { /* {{{ */
+    if (idx && ex->format != EXPLAIN_EXPORT_MSGPACK) {
+        smart_str_appendc(&ex->buf, ',');
+    }
+} /* }}} */
+
+static inline void explain_export_key(explain_export_t *ex, uint32_t idx, const char *name, size_t name_len) { /* {{{ */
+    explain_export_next(ex, idx);
+    explain_export_string(ex, name, name_len);
+
+    if (ex->format != EXPLAIN_EXPORT_MSGPACK) {
+        smart_str_appendc(&ex->buf, ':');
+    }
+} /* }}} */
+
+static void explain_export_zval(explain_export_t *ex, zval *value) { /* {{{ */
+    ZVAL_DEREF(value);
+
+    switch (Z_TYPE_P(value)) {
+        case IS_FALSE:  explain_export_bool(ex, 0); break;
+        case IS_TRUE:   explain_export_bool(ex, 1); break;
+        case IS_LONG:   explain_export_long(ex, Z_LVAL_P(value)); break;
+        case IS_DOUBLE: explain_export_double(ex, Z_DVAL_P(value)); break;
+        case IS_STRING: explain_export_string(ex, Z_STRVAL_P(value), Z_STRLEN_P(value)); break;
+
+        case IS_ARRAY: {
+            zend_ulong idx;
+            zend_string *key;
+            zval *member;
+            uint32_t pos = 0;
+
+            /* constant arrays are exported as maps, json keys must be strings */
+            explain_export_map(ex, zend_hash_num_elements(Z_ARRVAL_P(value)));
+            ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(value), idx, key, member) {
+                if (key) {
+                    explain_export_key(ex, pos++, ZSTR_VAL(key), ZSTR_LEN(key));
+                } else {
+                    char num[MAX_LENGTH_OF_LONG + 1];
+                    char *end = num + sizeof(num) - 1;
+                    char *str = zend_print_ulong_to_buf(end, idx);
+
+                    explain_export_key(ex, pos++, str, end - str);
+                }
+                explain_export_zval(ex, member);
+            } ZEND_HASH_FOREACH_END();
+            explain_export_end(ex, '}');
+        } break;
+
+        default:
+            explain_export_null(ex);
+    }
+} /* }}} */
+
+static inline void explain_export_fields(explain_export_t *ex, explain_export_field_t *fields, uint32_t count) { /* {{{ */
+    uint32_t idx;
+
+    explain_export_map(ex, count);
+    for (idx = 0; idx < count; idx++) {
+        explain_export_key(ex, idx, fields[idx].name, fields[idx].name_len);
+        explain_export_zval(ex, &fields[idx].value);
+    }
+    explain_export_end(ex, '}');
+} /* }}} */
+
+#define EXPLAIN_EXPORT_FIELD_LONG(n, v) do { \
+    fields[count].name = n; \
+    fields[count].name_len = sizeof(n) - 1; \
+    ZVAL_LONG(&fields[count].value, v); \
+    count++; \
+} while (0)
+
+#define EXPLAIN_EXPORT_FIELD_STR(n, v) do { \
+    fields[count].name = n; \
+    fields[count].name_len = sizeof(n) - 1; \
+    if (v) { \
+        ZVAL_STR(&fields[count].value, v); \
+    } else ZVAL_NULL(&fields[count].value); \
+    count++; \
+} while (0)
+
+static inline uint32_t explain_export_header(explain_export_t *ex, zend_op_array *ops, explain_export_field_t *fields) { /* {{{ */
+    uint32_t count = 0;
+
+    EXPLAIN_EXPORT_FIELD_STR("file", ex->file);
+    EXPLAIN_EXPORT_FIELD_STR("scope", ops->scope ? ops->scope->name : NULL);
+    EXPLAIN_EXPORT_FIELD_STR("function", ops->function_name);
+
+    return count;
+} /* }}} */
+
+static inline void explain_export_operand(zend_op_array *ops, znode_op *op, zend_uchar type, explain_export_temps_t *temps, zval *value) { /* {{{ */
+    switch (type) {
+        case IS_CV:
+            /* borrowed, the export never destroys field values */
+            ZVAL_STR(value, ops->vars[EX_VAR_TO_NUM(op->var)]);
+            break;
+
+        case IS_VAR:
+        case IS_TMP_VAR: {
+            uint32_t *id = &temps->ids[EX_VAR_TO_NUM(op->var) - ops->last_var];
+
+            if (!*id) {
+                *id = ++temps->next;
+            }
+
+            ZVAL_LONG(value, *id - 1);
+        } break;
+
+        case IS_CONST:
+            ZVAL_COPY_VALUE(value, RT_CONSTANT_EX(ops->literals, *op));
+            break;
+    }
+} /* }}} */
+
+static inline uint32_t explain_export_opline(explain_export_t *ex, zend_op_array *ops, zend_ulong next, explain_export_temps_t *temps, explain_export_field_t *fields, uint32_t count) { /* {{{ */
+    zend_op *opline = &ops->opcodes[next];
+    const explain_opcode_t *decode = explain_opcode_decode(opline->opcode);
+
+    EXPLAIN_EXPORT_FIELD_LONG("opline", next);
+    EXPLAIN_EXPORT_FIELD_LONG("opcode", opline->opcode);
+    EXPLAIN_EXPORT_FIELD_STR("name", decode ? decode->string : NULL);
+
+    if (decode && (decode->kind & EXPLAIN_OP1_OPLINE)) {
+        EXPLAIN_EXPORT_FIELD_LONG("op1_type", EXPLAIN_OPLINE);
+        EXPLAIN_EXPORT_FIELD_LONG("op1", explain_jmp_line(ops, &opline->op1, next));
+    } else if (!decode || !(decode->kind & EXPLAIN_RESULT_ONLY)) {
+        EXPLAIN_EXPORT_FIELD_LONG("op1_type", opline->op1_type);
+        if (opline->op1_type != IS_UNUSED) {
+            fields[count].name = "op1";
+            fields[count].name_len = sizeof("op1") - 1;
+            explain_export_operand(ops, &opline->op1, opline->op1_type, temps, &fields[count++].value);
+        }
+    }
+
+    if (decode && (decode->kind & EXPLAIN_OP2_OPLINE)) {
+        EXPLAIN_EXPORT_FIELD_LONG("op2_type", EXPLAIN_OPLINE);
+        EXPLAIN_EXPORT_FIELD_LONG("op2", explain_jmp_line(ops, &opline->op2, next));
+    } else if (!decode || !(decode->kind & EXPLAIN_RESULT_ONLY)) {
+        EXPLAIN_EXPORT_FIELD_LONG("op2_type", opline->op2_type);
+        if (opline->op2_type != IS_UNUSED) {
+            fields[count].name = "op2";
+            fields[count].name_len = sizeof("op2") - 1;
+            explain_export_operand(ops, &opline->op2, opline->op2_type, temps, &fields[count++].value);
+        }
+    }
+
+    EXPLAIN_EXPORT_FIELD_LONG("result_type", opline->result_type);
+    if (opline->result_type != IS_UNUSED) {
+        fields[count].name = "result";
+        fields[count].name_len = sizeof("result") - 1;
+        explain_export_operand(ops, &opline->result, opline->result_type, temps, &fields[count++].value);
+    }
+
+    if (decode && (decode->kind & EXPLAIN_EXT_OPLINE)) {
+        EXPLAIN_EXPORT_FIELD_LONG("extended_value", EXT_LINE(opline->extended_value, next));
+    } else if (opline->extended_value) {
+        EXPLAIN_EXPORT_FIELD_LONG("extended_value", opline->extended_value);
+    }
+
+    EXPLAIN_EXPORT_FIELD_LONG("lineno", opline->lineno);
+
+    return count;
+} /* }}} */
+
+static inline int explain_export_flush(explain_export_t *ex, zend_bool force) { /* {{{ */
+    if (ex->buf.s && ZSTR_LEN(ex->buf.s) && (force || ZSTR_LEN(ex->buf.s) >= EXPLAIN_EXPORT_FLUSH)) {
+        size_t length = ZSTR_LEN(ex->buf.s);
+
+        if (php_stream_write(ex->stream, ZSTR_VAL(ex->buf.s), length) != length) {
+            return FAILURE;
+        }
+
+        /* keep the allocation, it is reused for the next batch of records */
+        ZSTR_LEN(ex->buf.s) = 0;
+    }
+
+    return SUCCESS;
+} /* }}} */
+
+static inline void explain_export_record_end(explain_export_t *ex) { /* {{{ */
+    if (ex->format != EXPLAIN_EXPORT_MSGPACK) {
+        smart_str_appendc(&ex->buf, '\n');
+    }
+
+    ex->records++;
+} /* }}} */
+
+static int explain_export_op_array(explain_export_t *ex, zend_op_array *ops) { /* {{{ */
+    explain_export_field_t fields[EXPLAIN_EXPORT_FIELDS];
+    uint32_t header, count;
+    zend_ulong next;
+    explain_export_temps_t temps;
+
+    if (!ops->last) {
+        return SUCCESS;
+    }
+
+    temps.ids = ecalloc(ops->T ? ops->T : 1, sizeof(uint32_t));
+    temps.next = 0;
+
+    header = explain_export_header(ex, ops, fields);
+
+    if (ex->options & EXPLAIN_EXPORT_OP_ARRAY) {
+        explain_export_map(ex, header + 1);
+        for (count = 0; count < header; count++) {
+            explain_export_key(ex, count, fields[count].name, fields[count].name_len);
+            explain_export_zval(ex, &fields[count].value);
+        }
+
+        explain_export_key(ex, header, "oplines", sizeof("oplines") - 1);
+        explain_export_list(ex, ops->last);
+        for (next = 0; next < ops->last; next++) {
+            explain_export_next(ex, next);
+
+            count = explain_export_opline(ex, ops, next, &temps, fields, 0);
+            explain_export_fields(ex, fields, count);
+
+            if (explain_export_flush(ex, 0) != SUCCESS) {
+                efree(temps.ids);
+                return FAILURE;
+            }
+        }
+        explain_export_end(ex, ']');
+        explain_export_end(ex, '}');
+        explain_export_record_end(ex);
+    } else {
+        for (next = 0; next < ops->last; next++) {
+            count = explain_export_opline(ex, ops, next, &temps, fields, header);
+            explain_export_fields(ex, fields, count);
+            explain_export_record_end(ex);
+
+            if (explain_export_flush(ex, 0) != SUCCESS) {
+                efree(temps.ids);
+                return FAILURE;
+            }
+        }
+    }
+
+    efree(temps.ids);
+
+    return SUCCESS;
+} /* }}} */
+/* }}} */
+
+/* {{{ index
+ *
+ * With EXPLAIN_INDEX every explained op_array adds its declarations and
+ * call sites to a request wide index, explain_index_save() writes it out
+ * sorted so that explain_index_query() only has to binary search it.
+ *
+ * The file is a flat image in host byte order:
+ *
+ *   header
+ *   offsets[strings + 1]  offsets of the sorted strings into the blob
+ *   blob                  string bytes, padded to 4 bytes
+ *   symbols[symbols]      sorted by name, file, line
+ *   calls[calls]          sorted by callee, file, line
+ *   callers[calls]        positions in calls, sorted by caller, file, line
+ *
+ * Names are lowercase, methods are named class::method, a method called
+ * on an unknown object is ::method, and file level code is {main}.
+ */
+#define EXPLAIN_INDEX_MAGIC   "EXPLAIDX"
+#define EXPLAIN_INDEX_VERSION 1
+
+#define EXPLAIN_INDEX_SYMBOLS 1
+#define EXPLAIN_INDEX_CALLERS 2
+#define EXPLAIN_INDEX_CALLEES 3
+
+#define EXPLAIN_INDEX_CLASS    1
+#define EXPLAIN_INDEX_METHOD   2
+#define EXPLAIN_INDEX_FUNCTION 3
+
+#define EXPLAIN_INDEX_ALIGN(size) (((size) + 3) & ~3)
+
+typedef struct _explain_index_header_t {
+    char     magic[8];
+    uint32_t version;
+    uint32_t strings;
+    uint32_t blob;
+    uint32_t symbols;
+    uint32_t calls;
+    uint32_t reserved;
+} explain_index_header_t;
+
+typedef struct _explain_index_view_t {
+    const explain_index_header_t *header;
+    const uint32_t               *offsets;
+    const char                   *blob;
+    const explain_index_symbol_t *symbols;
+    const explain_index_call_t   *calls;
+    const uint32_t               *callers;
+} explain_index_view_t;
+
+typedef struct _explain_index_file_t {
+    php_stream          *stream;  /* open while mapped */
+    zend_string         *copy;    /* when the stream cannot be mapped */
+    const char          *error;
+    explain_index_view_t view;
+} explain_index_file_t;
+
+typedef struct _explain_index_caller_t {
+    uint32_t caller;
+    uint32_t file;
+    uint32_t line;
+    uint32_t position;
+} explain_index_caller_t;
+
+static inline void explain_index_init(explain_index_t *index) { /* {{{ */
+    memset(index, 0, sizeof(explain_index_t));
+
+    zend_hash_init(&index->strings, 64, NULL, NULL, 0);
+} /* }}} */
+
+static inline void explain_index_destroy(explain_index_t *index) { /* {{{ */
+    zend_hash_destroy(&index->strings);
+
+    if (index->symbols) {
+        efree(index->symbols);
+    }
+
+    if (index->calls) {
+        efree(index->calls);
+    }
+} /* }}} */
+
+static uint32_t explain_index_string(explain_index_t *index, const char *str, size_t len, zend_bool lower) { /* {{{ */
+    zend_string *key = zend_string_init(str, len, 0);
+    zval *found, id;
+
+    if (lower) {
+        zend_str_tolower(ZSTR_VAL(key), ZSTR_LEN(key));
+    }
+
+    if ((found = zend_hash_find(&index->strings, key))) {
+        zend_string_release(key);
+
+        return (uint32_t) Z_LVAL_P(found);
+    }
+
+    /* nothing is ever deleted, so ids follow insertion order */
+    ZVAL_LONG(&id, zend_hash_num_elements(&index->strings));
+
+    zend_hash_add_new(&index->strings, key, &id);
+    zend_string_release(key);
+
+    return (uint32_t) Z_LVAL(id);
+} /* }}} */
+
+static uint32_t explain_index_member(explain_index_t *index, const char *scope, size_t scope_len, const char *name, size_t name_len) { /* {{{ */
+    zend_string *member = strpprintf(0, "%.*s::%.*s", (int) scope_len, scope, (int) name_len, name);
+    uint32_t id = explain_index_string(index, ZSTR_VAL(member), ZSTR_LEN(member), 1);
+
+    zend_string_release(member);
+
+    return id;
+} /* }}} */
+
+static inline uint32_t explain_index_caller(explain_index_t *index, zend_op_array *ops) { /* {{{ */
+    if (!ops->function_name) {
+        return explain_index_string(index, "{main}", sizeof("{main}") - 1, 0);
+    }
+
+    if (ops->scope) {
+        return explain_index_member(index,
+            ZSTR_VAL(ops->scope->name), ZSTR_LEN(ops->scope->name),
+            ZSTR_VAL(ops->function_name), ZSTR_LEN(ops->function_name));
+    }
+
+    return explain_index_string(index, ZSTR_VAL(ops->function_name), ZSTR_LEN(ops->function_name), 1);
+} /* }}} */
+
+static inline void explain_index_symbol(explain_index_t *index, uint32_t name, uint32_t file, uint32_t line, uint32_t kind) { /* {{{ */
+    explain_index_symbol_t *symbol;
+
+    if (index->symbols_count == index->symbols_size) {
+        index->symbols_size = index->symbols_size ? index->symbols_size * 2 : 64;
+        index->symbols = safe_erealloc(index->symbols, index->symbols_size, sizeof(explain_index_symbol_t), 0);
+    }
+
+    symbol = &index->symbols[index->symbols_count++];
+    symbol->name = name;
+    symbol->file = file;
+    symbol->line = line;
+    symbol->kind = kind;
+} /* }}} */
+
+static inline void explain_index_call(explain_index_t *index, uint32_t caller, uint32_t callee, uint32_t file, zend_op *opline) { /* {{{ */
+    explain_index_call_t *call;
+
+    if (index->calls_count == index->calls_size) {
+        index->calls_size = index->calls_size ? index->calls_size * 2 : 256;
+        index->calls = safe_erealloc(index->calls, index->calls_size, sizeof(explain_index_call_t), 0);
+    }
+
+    call = &index->calls[index->calls_count++];
+    call->caller = caller;
+    call->callee = callee;
+    call->file = file;
+    call->line = opline->lineno;
+    call->opcode = opline->opcode;
+} /* }}} */
+
+static void explain_index_op_array(explain_index_t *index, zend_op_array *ops, uint32_t caller, uint32_t file) { /* {{{ */
+    zend_op *opline = ops->opcodes,
+            *end = ops->opcodes + ops->last;
+
+    for (; opline < end; opline++) {
+        zval *target = NULL,
+             *member = NULL;
+        zend_string *scope = NULL;
+        zend_bool method = 0;
+        uint32_t callee;
+
+        switch (opline->opcode) {
+            case ZEND_INIT_FCALL:
+            case ZEND_INIT_FCALL_BY_NAME:
+            case ZEND_INIT_NS_FCALL_BY_NAME:
+                if (opline->op2_type == IS_CONST) {
+                    target = RT_CONSTANT_EX(ops->literals, opline->op2);
+                }
+                break;
+
+            case ZEND_INIT_METHOD_CALL:
+                method = 1;
+                if (opline->op1_type == IS_UNUSED && ops->scope) {
+                    scope = ops->scope->name;
+                }
+                if (opline->op2_type == IS_CONST) {
+                    member = RT_CONSTANT_EX(ops->literals, opline->op2);
+                }
+                break;
+
+            case ZEND_INIT_STATIC_METHOD_CALL:
+                method = 1;
+                if (opline->op1_type == IS_CONST) {
+                    target = RT_CONSTANT_EX(ops->literals, opline->op1);
+                }
+#if PHP_VERSION_ID >= 70100
+                else if (opline->op1_type == IS_UNUSED && ops->scope) {
+                    switch (opline->op1.num & ZEND_FETCH_CLASS_MASK) {
+                        case ZEND_FETCH_CLASS_SELF:
+                        case ZEND_FETCH_CLASS_STATIC:
+                            scope = ops->scope->name;
+                            break;
+                    }
+                }
+#endif
+                if (opline->op2_type == IS_CONST) {
+                    member = RT_CONSTANT_EX(ops->literals, opline->op2);
+                }
+                break;
+
+            case ZEND_INCLUDE_OR_EVAL:
+                /* the argument of eval is code, not a name */
+                if (opline->extended_value == ZEND_EVAL) {
+                    break;
+                }
+                /* break intentionally omitted */
+
+            case ZEND_NEW:
+                if (opline->op1_type == IS_CONST) {
+                    target = RT_CONSTANT_EX(ops->literals, opline->op1);
+                }
+                break;
+
+            default:
+                continue;
+        }
+
+        if (target && Z_TYPE_P(target) != IS_STRING) {
+            target = NULL;
+        }
+
+        if (member && Z_TYPE_P(member) != IS_STRING) {
+            member = NULL;
+        }
+
+        if (method) {
+            if (target) {
+                scope = Z_STR_P(target);
+            }
+
+            callee = explain_index_member(index,
+                scope ? ZSTR_VAL(scope) : "", scope ? ZSTR_LEN(scope) : 0,
+                member ? Z_STRVAL_P(member) : "", member ? Z_STRLEN_P(member) : 0);
+        } else if (target) {
+            /* paths are case sensitive */
+            callee = explain_index_string(index,
+                Z_STRVAL_P(target), Z_STRLEN_P(target), opline->opcode != ZEND_INCLUDE_OR_EVAL);
+        } else callee = explain_index_string(index, "", 0, 0);
+
+        explain_index_call(index, caller, callee, file, opline);
+    }
+} /* }}} */
+
+static void explain_index_compiled(explain_index_t *index, zend_op_array *ops, explain_snapshot_t *snapshot) { /* {{{ */
+    uint32_t file = explain_index_string(index, ZSTR_VAL(ops->filename), ZSTR_LEN(ops->filename), 0);
+    zend_class_entry *pce;
+    zend_function *pfe;
+
+    explain_index_op_array(index, ops, explain_index_caller(index, ops), file);
+
+    EXPLAIN_FOREACH_DECLARED_PTR(CG(class_table), snapshot->classes, pce) {
+        if (pce->type != ZEND_USER_CLASS) {
+            continue;
+        }
+
+        explain_index_symbol(index,
+            explain_index_string(index, ZSTR_VAL(pce->name), ZSTR_LEN(pce->name), 1),
+            file, pce->info.user.line_start, EXPLAIN_INDEX_CLASS);
+
+        ZEND_HASH_FOREACH_PTR(&pce->function_table, pfe) {
+            if (pfe->common.type == ZEND_USER_FUNCTION && pfe->common.scope == pce) {
+                uint32_t caller = explain_index_caller(index, &pfe->op_array);
+
+                explain_index_symbol(index, caller, file, pfe->op_array.line_start, EXPLAIN_INDEX_METHOD);
+                explain_index_op_array(index, &pfe->op_array, caller, file);
+            }
+        } ZEND_HASH_FOREACH_END();
+    } EXPLAIN_FOREACH_END();
+
+    EXPLAIN_FOREACH_DECLARED_PTR(CG(function_table), snapshot->functions, pfe) {
+        if (pfe->common.type == ZEND_USER_FUNCTION) {
+            uint32_t caller = explain_index_caller(index, &pfe->op_array);
+
+            if (!(pfe->common.fn_flags & ZEND_ACC_CLOSURE)) {
+                explain_index_symbol(index, caller, file, pfe->op_array.line_start, EXPLAIN_INDEX_FUNCTION);
+            }
+
+            explain_index_op_array(index, &pfe->op_array, caller, file);
+        }
+    } EXPLAIN_FOREACH_END();
+} /* }}} */
+
+/* {{{ sorting for explain_index_save() */
+static int explain_index_string_compare(const void *a, const void *b) {
+    zend_string *l = *(zend_string**) a,
+                *r = *(zend_string**) b;
+
+    return zend_binary_strcmp(ZSTR_VAL(l), ZSTR_LEN(l), ZSTR_VAL(r), ZSTR_LEN(r));
+}
+
+static void explain_index_string_swap(void *a, void *b) {
+    zend_string *t = *(zend_string**) a;
+
+    *(zend_string**) a = *(zend_string**) b;
+    *(zend_string**) b = t;
+}
+
+#define EXPLAIN_INDEX_COMPARE(l, r) do { \
+    if ((l) != (r)) { \
+        return (l) < (r) ? -1 : 1; \
+    } \
+} while (0)
+
+static int explain_index_symbol_compare(const void *a, const void *b) {
+    const explain_index_symbol_t *l = a,
+                                 *r = b;
+
+    EXPLAIN_INDEX_COMPARE(l->name, r->name);
+    EXPLAIN_INDEX_COMPARE(l->file, r->file);
+    EXPLAIN_INDEX_COMPARE(l->line, r->line);
+
+    return 0;
+}
+
+static void explain_index_symbol_swap(void *a, void *b) {
+    explain_index_symbol_t t = *(explain_index_symbol_t*) a;
+
+    *(explain_index_symbol_t*) a = *(explain_index_symbol_t*) b;
+    *(explain_index_symbol_t*) b = t;
+}
+
+static int explain_index_call_compare(const void *a, const void *b) {
+    const explain_index_call_t *l = a,
+                               *r = b;
+
+    EXPLAIN_INDEX_COMPARE(l->callee, r->callee);
+    EXPLAIN_INDEX_COMPARE(l->file, r->file);
+    EXPLAIN_INDEX_COMPARE(l->line, r->line);
+    EXPLAIN_INDEX_COMPARE(l->caller, r->caller);
+
+    return 0;
+}
+
+static void explain_index_call_swap(void *a, void *b) {
+    explain_index_call_t t = *(explain_index_call_t*) a;
+
+    *(explain_index_call_t*) a = *(explain_index_call_t*) b;
+    *(explain_index_call_t*) b = t;
+}
+
+static int explain_index_caller_compare(const void *a, const void *b) {
+    const explain_index_caller_t *l = a,
+                                 *r = b;
+
+    EXPLAIN_INDEX_COMPARE(l->caller, r->caller);
+    EXPLAIN_INDEX_COMPARE(l->file, r->file);
+    EXPLAIN_INDEX_COMPARE(l->line, r->line);
+    EXPLAIN_INDEX_COMPARE(l->position, r->position);
+
+    return 0;
+}
+
+static void explain_index_caller_swap(void *a, void *b) {
+    explain_index_caller_t t = *(explain_index_caller_t*) a;
+
+    *(explain_index_caller_t*) a = *(explain_index_caller_t*) b;
+    *(explain_index_caller_t*) b = t;
+} /* }}} */
+
+/* {{{ a plain file is written beside the target and renamed over it, so a
+    mapping of the previous index, in this or any other process, never sees
+    a truncated file; other wrappers cannot be mapped and are written in place */
+static php_stream* explain_index_save_open(const char *path, char *target, zend_string **temp) {
+    const char *plain = path;
+    php_stream *stream;
+    int attempt;
+
+    *temp = NULL;
+
+    if (php_stream_locate_url_wrapper(path, &plain, 0) != &php_plain_files_wrapper) {
+        return php_stream_open_wrapper((char*) path, "wb", REPORT_ERRORS, NULL);
+    }
+
+    /* renaming over a symlink would replace the link, not the index */
+    if (!VCWD_REALPATH(plain, target) && !expand_filepath(plain, target)) {
+        return php_stream_open_wrapper((char*) path, "wb", REPORT_ERRORS, NULL);
+    }
+
+    for (attempt = 0; attempt < 8; attempt++) {
+        *temp = strpprintf(0, "%s.%08x.tmp", target, (uint32_t) (php_combined_lcg() * 0xffffffff));
+
+        /* created exclusively, and with the permissions of any new file */
+        if ((stream = php_stream_open_wrapper(ZSTR_VAL(*temp), "xb", 0, NULL))) {
+            return stream;
+        }
+
+        zend_string_release(*temp);
+        *temp = NULL;
+    }
+
+    return php_stream_open_wrapper(target, "wb", REPORT_ERRORS, NULL);
+} /* }}} */
+
+static int explain_index_save(explain_index_t *index, const char *path) { /* {{{ */
+    explain_index_header_t header;
+    uint32_t count = zend_hash_num_elements(&index->strings);
+    zend_string **strings = safe_emalloc(count, sizeof(zend_string*), 0);
+    uint32_t *ranks = safe_emalloc(count, sizeof(uint32_t), 0);
+    uint32_t *offsets = safe_emalloc(count + 1, sizeof(uint32_t), 0);
+    explain_index_symbol_t *symbols = NULL;
+    explain_index_call_t *calls = NULL;
+    explain_index_caller_t *callers = NULL;
+    zend_string *key, *temp;
+    zval *id;
+    php_stream *stream;
+    char target[MAXPATHLEN];
+    uint32_t it, blob = 0;
+    int result = SUCCESS;
+
+    ZEND_HASH_FOREACH_STR_KEY_VAL(&index->strings, key, id) {
+        strings[Z_LVAL_P(id)] = key;
+    } ZEND_HASH_FOREACH_END();
+
+    /* once the strings are sorted, comparing ids compares names */
+    zend_sort(strings, count, sizeof(zend_string*), explain_index_string_compare, explain_index_string_swap);
+
+    for (it = 0; it < count; it++) {
+        ranks[Z_LVAL_P(zend_hash_find(&index->strings, strings[it]))] = it;
+        offsets[it] = blob;
+        blob += ZSTR_LEN(strings[it]);
+    }
+    offsets[count] = blob;
+
+    if (index->symbols_count) {
+        symbols = safe_emalloc(index->symbols_count, sizeof(explain_index_symbol_t), 0);
+
+        for (it = 0; it < index->symbols_count; it++) {
+            symbols[it] = index->symbols[it];
+            symbols[it].name = ranks[symbols[it].name];
+            symbols[it].file = ranks[symbols[it].file];
+        }
+
+        zend_sort(symbols, index->symbols_count, sizeof(explain_index_symbol_t),
+            explain_index_symbol_compare, explain_index_symbol_swap);
+    }
+
+    if (index->calls_count) {
+        calls = safe_emalloc(index->calls_count, sizeof(explain_index_call_t), 0);
+        callers = safe_emalloc(index->calls_count, sizeof(explain_index_caller_t), 0);
+
+        for (it = 0; it < index->calls_count; it++) {
+            calls[it] = index->calls[it];
+            calls[it].caller = ranks[calls[it].caller];
+            calls[it].callee = ranks[calls[it].callee];
+            calls[it].file = ranks[calls[it].file];
+        }
+
+        zend_sort(calls, index->calls_count, sizeof(explain_index_call_t),
+            explain_index_call_compare, explain_index_call_swap);
+
+        for (it = 0; it < index->calls_count; it++) {
+            callers[it].caller = calls[it].caller;
+            callers[it].file = calls[it].file;
+            callers[it].line = calls[it].line;
+            callers[it].position = it;
+        }
+
+        zend_sort(callers, index->calls_count, sizeof(explain_index_caller_t),
+            explain_index_caller_compare, explain_index_caller_swap);
+    }
+
+    stream = explain_index_save_open(path, target, &temp);
+
+    if (!stream) {
+        result = FAILURE;
+        goto explain_index_save_end;
+    }
+
+    memset(&header, 0, sizeof(explain_index_header_t));
+    memcpy(header.magic, EXPLAIN_INDEX_MAGIC, sizeof(header.magic));
+    header.version = EXPLAIN_INDEX_VERSION;
+    header.strings = count;
+    header.blob = blob;
+    header.symbols = index->symbols_count;
+    header.calls = index->calls_count;
+
+#define EXPLAIN_INDEX_WRITE(buf, len) do { \
+    size_t _len = (len); \
+    if (_len && php_stream_write(stream, (const char*) (buf), _len) != _len) { \
+        result = FAILURE; \
+    } \
+} while (0)
+
+    EXPLAIN_INDEX_WRITE(&header, sizeof(explain_index_header_t));
+    EXPLAIN_INDEX_WRITE(offsets, (count + 1) * sizeof(uint32_t));
+
+    for (it = 0; it < count && result == SUCCESS; it++) {
+        EXPLAIN_INDEX_WRITE(ZSTR_VAL(strings[it]), ZSTR_LEN(strings[it]));
+    }
+    EXPLAIN_INDEX_WRITE("\0\0\0", EXPLAIN_INDEX_ALIGN(blob) - blob);
+
+    EXPLAIN_INDEX_WRITE(symbols, index->symbols_count * sizeof(explain_index_symbol_t));
+    EXPLAIN_INDEX_WRITE(calls, index->calls_count * sizeof(explain_index_call_t));
+
+    for (it = 0; it < index->calls_count && result == SUCCESS; it++) {
+        EXPLAIN_INDEX_WRITE(&callers[it].position, sizeof(uint32_t));
+    }
+
+#undef EXPLAIN_INDEX_WRITE
+
+    php_stream_close(stream);
+
+    if (temp) {
+        if (result == SUCCESS && VCWD_RENAME(ZSTR_VAL(temp), target) != 0) {
+            result = FAILURE;
+        }
+
+        if (result != SUCCESS) {
+            VCWD_UNLINK(ZSTR_VAL(temp));
+        }
+
+        zend_string_release(temp);
+    }
+
+explain_index_save_end:
+    efree(strings);
+    efree(ranks);
+    efree(offsets);
+
+    if (symbols) {
+        efree(symbols);
+    }
+
+    if (calls) {
+        efree(calls);
+        efree(callers);
+    }
+
+    return result;
+} /* }}} */
+
+/* {{{ check an index once when it is loaded, so queries can trust every offset
+    and id in it, and bisect it */
+static const char* explain_index_validate(const char *data, size_t len, explain_index_view_t *view) {
+    const explain_index_header_t *header = (const explain_index_header_t*) data;
+    uint64_t size;
+    uint32_t it;
+
+    if (len < sizeof(explain_index_header_t) ||
+        memcmp(header->magic, EXPLAIN_INDEX_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != EXPLAIN_INDEX_VERSION) {
+        return "is not an explain index";
+    }
+
+    size = sizeof(explain_index_header_t) +
+           ((uint64_t) header->strings + 1) * sizeof(uint32_t) +
+           EXPLAIN_INDEX_ALIGN((uint64_t) header->blob) +
+           (uint64_t) header->symbols * sizeof(explain_index_symbol_t) +
+           (uint64_t) header->calls * (sizeof(explain_index_call_t) + sizeof(uint32_t));
+
+    if (size != len) {
+        return "is a corrupted explain index";
+    }
+
+    view->header  = header;
+    view->offsets = (const uint32_t*) (header + 1);
+    view->blob    = (const char*) (view->offsets + header->strings + 1);
+    view->symbols = (const explain_index_symbol_t*) (view->blob + EXPLAIN_INDEX_ALIGN(header->blob));
+    view->calls   = (const explain_index_call_t*) (view->symbols + header->symbols);
+    view->callers = (const uint32_t*) (view->calls + header->calls);
+
+    for (it = 0; it < header->strings; it++) {
+        if (view->offsets[it] > view->offsets[it + 1]) {
+            return "is a corrupted explain index";
+        }
+    }
+
+    if (view->offsets[header->strings] != header->blob) {
+        return "is a corrupted explain index";
+    }
+
+    /* queries bisect everything, which only works on what was sorted by explain_index_save() */
+    for (it = 1; it < header->strings; it++) {
+        if (zend_binary_strcmp(
+                view->blob + view->offsets[it - 1], view->offsets[it] - view->offsets[it - 1],
+                view->blob + view->offsets[it], view->offsets[it + 1] - view->offsets[it]) >= 0) {
+            return "is an unsorted explain index";
+        }
+    }
+
+    for (it = 0; it < header->symbols; it++) {
+        if (view->symbols[it].name >= header->strings || view->symbols[it].file >= header->strings) {
+            return "is a corrupted explain index";
+        }
+
+        if (it && explain_index_symbol_compare(&view->symbols[it - 1], &view->symbols[it]) > 0) {
+            return "is an unsorted explain index";
+        }
+    }
+
+    for (it = 0; it < header->calls; it++) {
+        if (view->calls[it].caller >= header->strings ||
+            view->calls[it].callee >= header->strings ||
+            view->calls[it].file >= header->strings ||
+            view->callers[it] >= header->calls) {
+            return "is a corrupted explain index";
+        }
+
+        if (it && explain_index_call_compare(&view->calls[it - 1], &view->calls[it]) > 0) {
+            return "is an unsorted explain index";
+        }
+    }
+
+    for (it = 1; it < header->calls; it++) {
+        const explain_index_call_t *l = &view->calls[view->callers[it - 1]],
+                                   *r = &view->calls[view->callers[it]];
+        explain_index_caller_t left = {l->caller, l->file, l->line, view->callers[it - 1]},
+                               right = {r->caller, r->file, r->line, view->callers[it]};
+
+        /* positions are unique, so this also rejects a position listed twice */
+        if (explain_index_caller_compare(&left, &right) >= 0) {
+            return "is an unsorted explain index";
+        }
+    }
+
+    return NULL;
+} /* }}} */
+
+static void explain_index_file_free(zval *zv) { /* {{{ */
+    explain_index_file_t *file = Z_PTR_P(zv);
+
+    if (file->stream) {
+        php_stream_mmap_unmap(file->stream);
+        php_stream_close(file->stream);
+    }
+
+    if (file->copy) {
+        zend_string_release(file->copy);
+    }
+
+    efree(file);
+} /* }}} */
+
+static int explain_index_open(zend_string *path, explain_index_view_t *view) { /* {{{ */
+    explain_index_file_t *file = zend_hash_find_ptr(&EX_G(indexes), path);
+
+    if (!file) {
+        php_stream *stream = php_stream_open_wrapper(ZSTR_VAL(path), "rb", REPORT_ERRORS, NULL);
+        char *data = NULL;
+        size_t len = 0;
+
+        if (!stream) {
+            return FAILURE;
+        }
+
+        file = ecalloc(1, sizeof(explain_index_file_t));
+
+        /* mapped once per request, so a lookup only touches the pages it reads */
+        if (php_stream_mmap_possible(stream)) {
+            data = php_stream_mmap_range(stream, 0, PHP_STREAM_MMAP_ALL, PHP_STREAM_MAP_MODE_SHARED_READONLY, &len);
+        }
+
+        if (data) {
+            file->stream = stream;
+        } else {
+            file->copy = php_stream_copy_to_mem(stream, PHP_STREAM_COPY_ALL, 0);
+            php_stream_close(stream);
+
+            if (!file->copy) {
+                file->copy = ZSTR_EMPTY_ALLOC();
+            }
+
+            data = ZSTR_VAL(file->copy);
+            len = ZSTR_LEN(file->copy);
+        }
+
+        file->error = explain_index_validate(data, len, &file->view);
+
+        zend_hash_update_ptr(&EX_G(indexes), path, file);
+    }
+
+    if (file->error) {
+        zend_error(E_WARNING, "%s %s", ZSTR_VAL(path), file->error);
+        return FAILURE;
+    }
+
+    *view = file->view;
+
+    return SUCCESS;
+} /* }}} */
+
+static inline zend_bool explain_index_find(explain_index_view_t *view, const char *str, size_t len, uint32_t *id) { /* {{{ */
+    uint32_t low = 0,
+             high = view->header->strings;
+
+    while (low < high) {
+        uint32_t mid = low + ((high - low) >> 1);
+        int compare = zend_binary_strcmp(
+            view->blob + view->offsets[mid], view->offsets[mid + 1] - view->offsets[mid], str, len);
+
+        if (compare < 0) {
+            low = mid + 1;
+        } else if (compare > 0) {
+            high = mid;
+        } else {
+            *id = mid;
+            return 1;
+        }
+    }
+
+    return 0;
+} /* }}} */
+
+static inline void explain_index_add_string(explain_index_view_t *view, zval *record, const char *name, size_t name_len, uint32_t id) { /* {{{ */
+    add_assoc_stringl_ex(record, name, name_len,
+        (char*) view->blob + view->offsets[id], view->offsets[id + 1] - view->offsets[id]);
+} /* }}} */
+
+static void explain_index_add_symbol(explain_index_view_t *view, const explain_index_symbol_t *symbol, zval *return_value) { /* {{{ */
+    zval record;
+
+    array_init(&record);
+
+    explain_index_add_string(view, &record, "name", sizeof("name") - 1, symbol->name);
+    switch (symbol->kind) {
+        case EXPLAIN_INDEX_CLASS:
+            add_assoc_stringl_ex(&record, "kind", sizeof("kind") - 1, "class", sizeof("class") - 1);
+            break;
+        case EXPLAIN_INDEX_METHOD:
+            add_assoc_stringl_ex(&record, "kind", sizeof("kind") - 1, "method", sizeof("method") - 1);
+            break;
+        default:
+            add_assoc_stringl_ex(&record, "kind", sizeof("kind") - 1, "function", sizeof("function") - 1);
+    }
+    explain_index_add_string(view, &record, "file", sizeof("file") - 1, symbol->file);
+    add_assoc_long_ex(&record, "line", sizeof("line") - 1, symbol->line);
+
+    add_next_index_zval(return_value, &record);
+} /* }}} */
+
+static void explain_index_add_call(explain_index_view_t *view, const explain_index_call_t *call, zval *return_value) { /* {{{ */
+    zval record;
+
+    array_init(&record);
+
+    explain_index_add_string(view, &record, "caller", sizeof("caller") - 1, call->caller);
+    explain_index_add_string(view, &record, "callee", sizeof("callee") - 1, call->callee);
+    add_assoc_long_ex(&record, "opcode", sizeof("opcode") - 1, call->opcode);
+    explain_index_add_string(view, &record, "file", sizeof("file") - 1, call->file);
+    add_assoc_long_ex(&record, "line", sizeof("line") - 1, call->line);
+
+    add_next_index_zval(return_value, &record);
+} /* }}} */
+
+static void explain_index_query(explain_index_view_t *view, uint32_t id, zend_long type, zval *return_value) { /* {{{ */
+    uint32_t low = 0, high, mid;
+
+    switch (type) {
+        case EXPLAIN_INDEX_SYMBOLS:
+            high = view->header->symbols;
+            while (low < high) {
+                mid = low + ((high - low) >> 1);
+                if (view->symbols[mid].name < id) {
+                    low = mid + 1;
+                } else high = mid;
+            }
+
+            for (; low < view->header->symbols && view->symbols[low].name == id; low++) {
+                explain_index_add_symbol(view, &view->symbols[low], return_value);
+            }
+            break;
+
+        case EXPLAIN_INDEX_CALLERS:
+            high = view->header->calls;
+            while (low < high) {
+                mid = low + ((high - low) >> 1);
+                if (view->calls[mid].callee < id) {
+                    low = mid + 1;
+                } else high = mid;
+            }
+
+            for (; low < view->header->calls && view->calls[low].callee == id; low++) {
+                explain_index_add_call(view, &view->calls[low], return_value);
+            }
+            break;
+
+        case EXPLAIN_INDEX_CALLEES:
+            high = view->header->calls;
+            while (low < high) {
+                mid = low + ((high - low) >> 1);
+                if (view->calls[view->callers[mid]].caller < id) {
+                    low = mid + 1;
+                } else high = mid;
+            }
+
+            for (; low < view->header->calls && view->calls[view->callers[low]].caller == id; low++) {
+                explain_index_add_call(view, &view->calls[view->callers[low]], return_value);
+            }
+            break;
+    }
+} /* }}} */
+/* }}} */
+
+/* {{{ diff
+ *
+ * explain_diff() compiles both versions of some code, matches their op_arrays
+ * by name and aligns the oplines of each pair with a Myers diff.
+ *
+ * Oplines are compared by fingerprint: opcode, operand types, constants,
+ * CV names and extended_value. Temporaries, jump targets and the keys of
+ * runtime declarations are left out, they are renumbered by any edit and
+ * would make every later opline differ.
+ *
+ * Closures are named after the unit declaring them and their line in it,
+ * as in {main}/{closure}:3 or class::method/{closure}:1.
+ */
+#define EXPLAIN_DIFF_DELETE 1
+#define EXPLAIN_DIFF_INSERT 2
+
+/* past this many edits an op_array is reported as rewritten, the trace kept
+    for backtracking is (edits + 1)^2 ints, about 1MB at this limit */
+#define EXPLAIN_DIFF_MAX_EDITS 512
+
+typedef struct _explain_diff_side_t {
+    zend_op_array *ops;
+    explain_snapshot_t snapshot;
+    HashTable classes;
+    HashTable functions;
+    HashTable units;
+} explain_diff_side_t;
+
+typedef struct _explain_diff_edit_t {
+    uint32_t type;
+    uint32_t opline;
+} explain_diff_edit_t;
+
+static inline uint64_t explain_diff_mix(uint64_t hash, uint64_t value) { /* {{{ */
+    return hash ^ (value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2));
+} /* }}} */
+
+static uint64_t explain_diff_literal(zval *literal) { /* {{{ */
+    uint64_t value = 0;
+
+    switch (Z_TYPE_P(literal)) {
+        case IS_LONG:     value = (uint64_t) Z_LVAL_P(literal); break;
+        case IS_DOUBLE:   memcpy(&value, &Z_DVAL_P(literal), sizeof(double)); break;
+        case IS_STRING:
+        case IS_CONSTANT: value = zend_string_hash_val(Z_STR_P(literal)); break;
+
+        case IS_ARRAY: {
+            zend_ulong idx;
+            zend_string *key;
+            zval *member;
+
+            /* every key and value, in order, or [1, 2] and [3, 4] would not differ */
+            value = zend_hash_num_elements(Z_ARRVAL_P(literal));
+            ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(literal), idx, key, member) {
+                value = explain_diff_mix(value, key ? zend_string_hash_val(key) : idx);
+                value = explain_diff_mix(value, explain_diff_literal(member));
+            } ZEND_HASH_FOREACH_END();
+        } break;
+    }
+
+    return explain_diff_mix(Z_TYPE_P(literal), value);
+} /* }}} */
+
+static inline uint64_t explain_diff_operand(zend_op_array *ops, znode_op *op, zend_uchar type) { /* {{{ */
+    switch (type) {
+        case IS_CV:
+            return zend_string_hash_val(ops->vars[EX_VAR_TO_NUM(op->var)]);
+
+        case IS_CONST:
+            return explain_diff_literal(RT_CONSTANT_EX(ops->literals, *op));
+    }
+
+    return 0;
+} /* }}} */
+
+/* {{{ the op1 of a runtime declaration is a key made of the file and the
+    position of the declaration, which any edit above it moves */
+static inline zend_bool explain_diff_declaration(zend_uchar opcode) {
+    switch (opcode) {
+        case ZEND_DECLARE_FUNCTION:
+        case ZEND_DECLARE_LAMBDA_FUNCTION:
+        case ZEND_DECLARE_CLASS:
+        case ZEND_DECLARE_INHERITED_CLASS:
+        case ZEND_DECLARE_INHERITED_CLASS_DELAYED:
+        case ZEND_DECLARE_ANON_CLASS:
+        case ZEND_DECLARE_ANON_INHERITED_CLASS:
+            return 1;
+    }
+
+    return 0;
+} /* }}} */
+
+static uint64_t* explain_diff_fingerprint(zend_op_array *ops) { /* {{{ */
+    uint64_t *fingerprints;
+    uint32_t next;
+
+    if (!ops || !ops->last) {
+        return NULL;
+    }
+
+    fingerprints = safe_emalloc(ops->last, sizeof(uint64_t), 0);
+
+    for (next = 0; next < ops->last; next++) {
+        zend_op *opline = &ops->opcodes[next];
+        const explain_opcode_t *decode = explain_opcode_decode(opline->opcode);
+        uint32_t kind = decode ? decode->kind : 0;
+        uint64_t hash = opline->opcode;
+
+        if (kind & EXPLAIN_OP1_OPLINE) {
+            hash = explain_diff_mix(hash, EXPLAIN_OPLINE);
+        } else if (explain_diff_declaration(opline->opcode)) {
+            hash = explain_diff_mix(hash, opline->op1_type);
+        } else {
+            hash = explain_diff_mix(hash, opline->op1_type);
+            hash = explain_diff_mix(hash, explain_diff_operand(ops, &opline->op1, opline->op1_type));
+        }
+
+        if (kind & EXPLAIN_OP2_OPLINE) {
+            hash = explain_diff_mix(hash, EXPLAIN_OPLINE);
+        } else {
+            hash = explain_diff_mix(hash, opline->op2_type);
+            hash = explain_diff_mix(hash, explain_diff_operand(ops, &opline->op2, opline->op2_type));
+        }
+
+        hash = explain_diff_mix(hash, opline->result_type);
+
+        if (!(kind & EXPLAIN_EXT_OPLINE)) {
+            hash = explain_diff_mix(hash, opline->extended_value);
+        }
+
+        fingerprints[next] = hash;
+    }
+
+    return fingerprints;
+} /* }}} */
+
+static inline void explain_diff_edit(explain_diff_edit_t **edits, uint32_t *count, uint32_t type, uint32_t opline) { /* {{{ */
+    if (!(*count & 63)) {
+        *edits = safe_erealloc(*edits, *count + 64, sizeof(explain_diff_edit_t), 0);
+    }
+
+    (*edits)[*count].type = type;
+    (*edits)[*count].opline = opline;
+    (*count)++;
+} /* }}} */
+
+/* {{{ Myers' O(ND) diff of a[offset..offset+n] and b[offset..offset+m], edits are appended in reverse */
+static int explain_diff_myers(const uint64_t *a, int32_t n, const uint64_t *b, int32_t m, uint32_t offset, explain_diff_edit_t **edits, uint32_t *count) {
+    int32_t max = n + m,
+            limit = MIN(max, EXPLAIN_DIFF_MAX_EDITS),
+            d, k, x, y;
+    int32_t *v = ecalloc(2 * (size_t) max + 3, sizeof(int32_t)),
+            *trace = NULL;
+    size_t capacity = 0;
+
+#define V(k)     v[max + 1 + (k)]
+#define TRACE(k) trace[(size_t) d * d + d + (k)]
+
+    for (d = 0; d <= limit; d++) {
+        /* V before step d, all that backtracking needs of it is -d..d */
+        if ((size_t) (d + 1) * (d + 1) > capacity) {
+            /* grown geometrically, reallocating every step copies O(D^3) */
+            capacity = MIN(MAX((size_t) (d + 1) * (d + 1), capacity * 2), (size_t) (limit + 1) * (limit + 1));
+            trace = safe_erealloc(trace, capacity, sizeof(int32_t), 0);
+        }
+        memcpy(&TRACE(-d), &V(-d), (2 * (size_t) d + 1) * sizeof(int32_t));
+
+        for (k = -d; k <= d; k += 2) {
+            if (k == -d || (k != d && V(k - 1) < V(k + 1))) {
+                x = V(k + 1);
+            } else x = V(k - 1) + 1;
+
+            y = x - k;
+
+            while (x < n && y < m && a[x] == b[y]) {
+                x++;
+                y++;
+            }
+
+            V(k) = x;
+
+            if (x >= n && y >= m) {
+                goto explain_diff_myers_found;
+            }
+        }
+    }
+
+    efree(v);
+    efree(trace);
+
+    return FAILURE;
+
+explain_diff_myers_found:
+    x = n;
+    y = m;
+
+    for (; d > 0; d--) {
+        int32_t px, py, pk;
+
+        k = x - y;
+
+        if (k == -d || (k != d && TRACE(k - 1) < TRACE(k + 1))) {
+            pk = k + 1;
+        } else pk = k - 1;
+
+        px = TRACE(pk);
+        py = px - pk;
+
+        while (x > px && y > py) {
+            x--;
+            y--;
+        }
+
+        if (x == px) {
+            explain_diff_edit(edits, count, EXPLAIN_DIFF_INSERT, offset + py);
+        } else explain_diff_edit(edits, count, EXPLAIN_DIFF_DELETE, offset + px);
+
+        x = px;
+        y = py;
+    }
+
+#undef V
+#undef TRACE
+
+    efree(v);
+    efree(trace);
+
+    return SUCCESS;
+} /* }}} */
+
+static void explain_diff_op_arrays(zend_string *name, zend_op_array *a, zend_op_array *b, zval *return_value) { /* {{{ */
+    uint64_t *fa = explain_diff_fingerprint(a),
+             *fb = explain_diff_fingerprint(b);
+    int32_t n = a ? a->last : 0,
+            m = b ? b->last : 0,
+            prefix = 0, suffix = 0, it;
+    int32_t histogram[256];
+    explain_diff_edit_t *edits = NULL;
+    uint32_t count = 0, edit;
+    zend_llist vars[2];
+    zval record, opcodes, changes;
+
+    while (prefix < n && prefix < m && fa[prefix] == fb[prefix]) {
+        prefix++;
+    }
+
+    while (suffix < n - prefix && suffix < m - prefix && fa[n - 1 - suffix] == fb[m - 1 - suffix]) {
+        suffix++;
+    }
+
+    if (a && b && prefix == n && prefix == m) {
+        goto explain_diff_op_arrays_end;
+    }
+
+    if (explain_diff_myers(fa + prefix, n - prefix - suffix, fb + prefix, m - prefix - suffix, prefix, &edits, &count) != SUCCESS) {
+        /* rewritten, everything between the common prefix and suffix changed */
+        count = 0;
+
+        for (it = m - suffix - 1; it >= prefix; it--) {
+            explain_diff_edit(&edits, &count, EXPLAIN_DIFF_INSERT, it);
+        }
+
+        for (it = n - suffix - 1; it >= prefix; it--) {
+            explain_diff_edit(&edits, &count, EXPLAIN_DIFF_DELETE, it);
+        }
+    }
+
+    memset(histogram, 0, sizeof(histogram));
+
+    for (it = 0; it < n; it++) {
+        histogram[a->opcodes[it].opcode]--;
+    }
+
+    for (it = 0; it < m; it++) {
+        histogram[b->opcodes[it].opcode]++;
+    }
+
+    array_init(&record);
+
+    if (!a) {
+        add_assoc_stringl_ex(&record, "status", sizeof("status") - 1, "added", sizeof("added") - 1);
+    } else if (!b) {
+        add_assoc_stringl_ex(&record, "status", sizeof("status") - 1, "removed", sizeof("removed") - 1);
+    } else add_assoc_stringl_ex(&record, "status", sizeof("status") - 1, "changed", sizeof("changed") - 1);
+
+    add_assoc_long_ex(&record, "old", sizeof("old") - 1, n);
+    add_assoc_long_ex(&record, "new", sizeof("new") - 1, m);
+    add_assoc_long_ex(&record, "delta", sizeof("delta") - 1, m - n);
+
+    array_init(&opcodes);
+    for (it = 0; it < 256; it++) {
+        if (histogram[it]) {
+            const explain_opcode_t *decode = explain_opcode_decode(it);
+
+            if (decode) {
+                add_assoc_long_ex(&opcodes, decode->name, decode->name_len, histogram[it]);
+            } else add_index_long(&opcodes, it, histogram[it]);
+        }
+    }
+    add_assoc_zval_ex(&record, "opcodes", sizeof("opcodes") - 1, &opcodes);
+
+    zend_llist_init(&vars[0], sizeof(size_t), NULL, 0);
+    zend_llist_init(&vars[1], sizeof(size_t), NULL, 0);
+
+    array_init(&changes);
+    for (edit = count; edit > 0; edit--) {
+        explain_diff_edit_t *change = &edits[edit - 1];
+        zval zopline;
+
+        if (change->type == EXPLAIN_DIFF_DELETE) {
+            explain_opline(a, change->opline, &vars[0], &zopline);
+            add_assoc_stringl_ex(&zopline, "diff", sizeof("diff") - 1, "-", 1);
+        } else {
+            explain_opline(b, change->opline, &vars[1], &zopline);
+            add_assoc_stringl_ex(&zopline, "diff", sizeof("diff") - 1, "+", 1);
+        }
+
+        add_next_index_zval(&changes, &zopline);
+    }
+    add_assoc_zval_ex(&record, "changes", sizeof("changes") - 1, &changes);
+
+    zend_llist_destroy(&vars[0]);
+    zend_llist_destroy(&vars[1]);
+
+    add_assoc_zval_ex(return_value, ZSTR_VAL(name), ZSTR_LEN(name), &record);
+
+explain_diff_op_arrays_end:
+    if (fa) {
+        efree(fa);
+    }
+
+    if (fb) {
+        efree(fb);
+    }
+
+    if (edits) {
+        efree(edits);
+    }
+} /* }}} */
+
+static inline void explain_diff_unit(explain_diff_side_t *side, zend_string *name, zend_op_array *ops) { /* {{{ */
+    zend_string *key = zend_string_tolower(name);
+
+    zend_hash_update_ptr(&side->units, key, ops);
+    zend_string_release(key);
+} /* }}} */
+
+/* {{{ closures are named by the unit declaring them and their line within it,
+    so code added elsewhere does not rename them; the ordinal only tells apart
+    closures declared on the same line */
+static void explain_diff_closures(explain_diff_side_t *side, zend_string *scope, zend_op_array *ops) {
+    zend_op *opline = ops->opcodes,
+            *end = ops->opcodes + ops->last;
+
+    for (; opline < end; opline++) {
+        zend_function *closure;
+        zend_string *name, *key;
+        zval *literal;
+        uint32_t ordinal = 1;
+
+        if (opline->opcode != ZEND_DECLARE_LAMBDA_FUNCTION || opline->op1_type != IS_CONST) {
+            continue;
+        }
+
+        literal = RT_CONSTANT_EX(ops->literals, opline->op1);
+
+        if (Z_TYPE_P(literal) != IS_STRING ||
+            !(closure = zend_hash_find_ptr(&side->functions, Z_STR_P(literal)))) {
+            continue;
+        }
+
+        name = strpprintf(0, "%s/{closure}:%u", ZSTR_VAL(scope), closure->op_array.line_start - ops->line_start);
+        key = zend_string_tolower(name);
+
+        while (!zend_hash_add_ptr(&side->units, key, &closure->op_array)) {
+            zend_string_release(key);
+            key = strpprintf(0, "%s#%u", ZSTR_VAL(name), ++ordinal);
+            zend_str_tolower(ZSTR_VAL(key), ZSTR_LEN(key));
+        }
+
+        explain_diff_closures(side, key, &closure->op_array);
+
+        zend_string_release(name);
+        zend_string_release(key);
+    }
+} /* }}} */
+
+static int explain_diff_compile(zval *code, zend_ulong options, explain_diff_side_t *side) { /* {{{ */
+    zend_class_entry *pce;
+    zend_function *pfe;
+    zend_string *name;
+
+    side->ops = explain_compile(code, options | EXPLAIN_ISOLATE, &side->snapshot);
+
+    if (!side->ops) {
+        return FAILURE;
+    }
+
+    /* both versions declare the same symbols, keep them out of the tables */
+    explain_detach_table(CG(function_table), side->snapshot.functions, &side->functions);
+    explain_detach_table(CG(class_table), side->snapshot.classes, &side->classes);
+
+    zend_hash_init(&side->units, 8, NULL, NULL, 0);
+
+    name = zend_string_init("{main}", sizeof("{main}") - 1, 0);
+    explain_diff_unit(side, name, side->ops);
+    explain_diff_closures(side, name, side->ops);
+    zend_string_release(name);
+
+    ZEND_HASH_FOREACH_PTR(&side->classes, pce) {
+        if (pce->type != ZEND_USER_CLASS) {
+            continue;
+        }
+
+        ZEND_HASH_FOREACH_PTR(&pce->function_table, pfe) {
+            if (pfe->common.type == ZEND_USER_FUNCTION && pfe->common.scope == pce) {
+                name = strpprintf(0, "%s::%s", ZSTR_VAL(pce->name), ZSTR_VAL(pfe->common.function_name));
+
+                explain_diff_unit(side, name, &pfe->op_array);
+                explain_diff_closures(side, name, &pfe->op_array);
+                zend_string_release(name);
+            }
+        } ZEND_HASH_FOREACH_END();
+    } ZEND_HASH_FOREACH_END();
+
+    ZEND_HASH_FOREACH_PTR(&side->functions, pfe) {
+        /* closures were named from the code declaring them */
+        if (pfe->common.type != ZEND_USER_FUNCTION || (pfe->common.fn_flags & ZEND_ACC_CLOSURE)) {
+            continue;
+        }
+
+        explain_diff_unit(side, pfe->common.function_name, &pfe->op_array);
+        explain_diff_closures(side, pfe->common.function_name, &pfe->op_array);
+    } ZEND_HASH_FOREACH_END();
+
+    return SUCCESS;
+} /* }}} */
+
+static void explain_diff_release(explain_diff_side_t *side) { /* {{{ */
+    if (side->ops) {
+        zend_hash_destroy(&side->units);
+        php_explain_destroy_ops(&side->ops);
+        zend_hash_destroy(&side->functions);
+        zend_hash_destroy(&side->classes);
+    }
+} /* }}} */
+/* }}} */
+
+/* {{{ lint
+ *
+ * explain_lint() runs a table of rules over the oplines of everything a
+ * file compiles to. Each rule names the opcodes it triggers on, MINIT
+ * compiles the table into a per opcode mask of rules, so an opline only
+ * ever reaches the matchers that can fire on it.
+ *
+ * Loops are found from the jump structure: a jump to an earlier opline
+ * closes a loop over the oplines in between. When that jump is conditional
+ * and the loop was entered by a jump forward into its condition, as while
+ * and for are, the oplines from the entry to the back edge are the loop
+ * condition; otherwise the condition is what computes the value tested.
+ *
+ * To add a rule, give it the next EXPLAIN_LINT_* bit, write a matcher that
+ * returns the message of a finding or NULL, and add it to the table.
+ */
+#define EXPLAIN_LINT_LOOP_CONDITION    (1<<0)
+#define EXPLAIN_LINT_DYNAMIC_FETCH     (1<<1)
+#define EXPLAIN_LINT_LOOP_CONCAT       (1<<2)
+#define EXPLAIN_LINT_NS_FCALL          (1<<3)
+#define EXPLAIN_LINT_REPEATED_CONSTANT (1<<4)
+
+#define EXPLAIN_LINT_ALL \
+    (EXPLAIN_LINT_LOOP_CONDITION|EXPLAIN_LINT_DYNAMIC_FETCH|EXPLAIN_LINT_LOOP_CONCAT|EXPLAIN_LINT_NS_FCALL|EXPLAIN_LINT_REPEATED_CONSTANT)
+
+/* opline flags */
+#define EXPLAIN_LINT_IN_LOOP      (1<<0)
+#define EXPLAIN_LINT_IN_CONDITION (1<<1)
+
+#define EXPLAIN_LINT_TRIGGERS 16
+
+typedef struct _explain_lint_t {
+    zend_op_array *ops;
+    zend_uchar    *flags;
+    HashTable      constants;
+} explain_lint_t;
+
+typedef struct _explain_lint_rule_t {
+    uint32_t    rule;
+    const char *name;
+    size_t      name_len;
+    zend_string* (*match)(explain_lint_t *lint, zend_op *opline);
+    /* zero terminated, ZEND_NOP never triggers a rule */
+    zend_uchar  triggers[EXPLAIN_LINT_TRIGGERS];
+} explain_lint_rule_t;
+
+static inline zend_bool explain_lint_function_name(zend_op_array *ops, zend_op *opline, const char **name, size_t *name_len) { /* {{{ */
+    zval *function;
+    const char *sep;
+
+    switch (opline->opcode) {
+        case ZEND_STRLEN:
+            *name = "strlen";
+            *name_len = sizeof("strlen") - 1;
+            return 1;
+    }
+
+    if (opline->op2_type != IS_CONST) {
+        return 0;
+    }
+
+    function = RT_CONSTANT_EX(ops->literals, opline->op2);
+
+    if (Z_TYPE_P(function) != IS_STRING) {
+        return 0;
+    }
+
+    /* unqualified calls in a namespace fall back to the global function */
+    sep = zend_memrchr(Z_STRVAL_P(function), '\\', Z_STRLEN_P(function));
+
+    *name = sep ? sep + 1 : Z_STRVAL_P(function);
+    *name_len = Z_STRVAL_P(function) + Z_STRLEN_P(function) - *name;
+
+    return 1;
+} /* }}} */
+
+static zend_string* explain_lint_loop_condition(explain_lint_t *lint, zend_op *opline) { /* {{{ */
+    const char *name;
+    size_t name_len;
+
+    if (!(lint->flags[opline - lint->ops->opcodes] & EXPLAIN_LINT_IN_CONDITION) ||
+        !explain_lint_function_name(lint->ops, opline, &name, &name_len)) {
+        return NULL;
+    }
+
+    if (zend_binary_strcasecmp(name, name_len, "count", sizeof("count") - 1) != 0 &&
+        zend_binary_strcasecmp(name, name_len, "sizeof", sizeof("sizeof") - 1) != 0 &&
+        zend_binary_strcasecmp(name, name_len, "strlen", sizeof("strlen") - 1) != 0) {
+        return NULL;
+    }
+
+    return strpprintf(0, "%.*s() is called by the loop condition on every iteration", (int) name_len, name);
+} /* }}} */
+
+static zend_string* explain_lint_dynamic_fetch(explain_lint_t *lint, zend_op *opline) { /* {{{ */
+    switch (opline->opcode) {
+        case ZEND_FETCH_R:
+        case ZEND_FETCH_W:
+        case ZEND_FETCH_RW:
+        case ZEND_FETCH_IS:
+        case ZEND_FETCH_UNSET:
+        case ZEND_FETCH_FUNC_ARG:
+            if (opline->op1_type != IS_CONST) {
+                return strpprintf(0, "variable fetched by a name only known at runtime");
+            }
+            break;
+
+        default:
+            if (opline->op2_type != IS_CONST) {
+                return strpprintf(0, "property fetched by a name only known at runtime");
+            }
+    }
+
+    return NULL;
+} /* }}} */
+
+static inline zend_op* explain_lint_concat(zend_op_array *ops, zend_op *use, uint32_t var) { /* {{{ */
+    zend_op *opline;
+
+    /* temporaries are used once, right after they are defined, so the nearest definition is it */
+    for (opline = use - 1; opline >= ops->opcodes; opline--) {
+        if (opline->result_type == IS_TMP_VAR && opline->result.var == var) {
+            return (opline->opcode == ZEND_CONCAT || opline->opcode == ZEND_FAST_CONCAT) ? opline : NULL;
+        }
+    }
+
+    return NULL;
+} /* }}} */
+
+static zend_string* explain_lint_loop_concat(explain_lint_t *lint, zend_op *opline) { /* {{{ */
+    zend_op_array *ops = lint->ops;
+    zend_op *concat;
+    zend_string *var;
+
+    /* $s .= $x extends $s in place, only $s = $s . $x copies it */
+    if (!(lint->flags[opline - ops->opcodes] & EXPLAIN_LINT_IN_LOOP) ||
+        opline->op1_type != IS_CV || opline->op2_type != IS_TMP_VAR) {
+        return NULL;
+    }
+
+    /* follow the left operand down a chain, $s = $s . $x . $y */
+    concat = explain_lint_concat(ops, opline, opline->op2.var);
+
+    while (concat && concat->op1_type == IS_TMP_VAR) {
+        concat = explain_lint_concat(ops, concat, concat->op1.var);
+    }
+
+    if (!concat || concat->op1_type != IS_CV || concat->op1.var != opline->op1.var) {
+        return NULL;
+    }
+
+    var = ops->vars[EX_VAR_TO_NUM(opline->op1.var)];
+
+    return strpprintf(0, "$%s = $%s . ... copies $%s on every iteration of a loop, use .=", ZSTR_VAL(var), ZSTR_VAL(var), ZSTR_VAL(var));
+} /* }}} */
+
+static zend_string* explain_lint_ns_fcall(explain_lint_t *lint, zend_op *opline) { /* {{{ */
+    zval *function;
+    const char *name;
+    size_t name_len;
+    zend_string *key;
+    zend_bool declared;
+
+    if (opline->op2_type != IS_CONST ||
+        !explain_lint_function_name(lint->ops, opline, &name, &name_len)) {
+        return NULL;
+    }
+
+    function = RT_CONSTANT_EX(lint->ops->literals, opline->op2);
+
+    key = zend_string_tolower(Z_STR_P(function));
+    declared = zend_hash_exists(EG(function_table), key);
+    zend_string_release(key);
+
+    if (declared) {
+        return NULL;
+    }
+
+    key = zend_string_alloc(name_len, 0);
+    zend_str_tolower_copy(ZSTR_VAL(key), name, name_len);
+    declared = zend_hash_exists(EG(function_table), key);
+    zend_string_release(key);
+
+    if (!declared) {
+        return NULL;
+    }
+
+    return strpprintf(0, "%s() falls back to \\%.*s() at runtime, write \\%.*s() or import it with use function",
+        Z_STRVAL_P(function), (int) name_len, name, (int) name_len, name);
+} /* }}} */
+
+static zend_string* explain_lint_repeated_constant(explain_lint_t *lint, zend_op *opline) { /* {{{ */
+    zend_op_array *ops = lint->ops;
+    zval *constant, *scope, *seen, reported;
+    zend_string *name;
+
+    if (opline->op2_type != IS_CONST) {
+        return NULL;
+    }
+
+    constant = RT_CONSTANT_EX(ops->literals, opline->op2);
+
+    if (Z_TYPE_P(constant) != IS_STRING) {
+        return NULL;
+    }
+
+    if (opline->op1_type == IS_CONST) {
+        scope = RT_CONSTANT_EX(ops->literals, opline->op1);
+
+        if (Z_TYPE_P(scope) != IS_STRING) {
+            return NULL;
+        }
+
+        name = strpprintf(0, "%s::%s", Z_STRVAL_P(scope), Z_STRVAL_P(constant));
+    } else if (opline->op1_type != IS_UNUSED) {
+        /* classes only known at runtime */
+        return NULL;
+#ifdef ZEND_FETCH_CLASS_CONSTANT
+    } else if (opline->opcode == ZEND_FETCH_CONSTANT) {
+#else
+    } else if (opline->op1.num == 0) {
+#endif
+        name = zend_string_copy(Z_STR_P(constant));
+    } else if ((opline->op1.num & ZEND_FETCH_CLASS_MASK) == ZEND_FETCH_CLASS_SELF) {
+        name = strpprintf(0, "self::%s", Z_STRVAL_P(constant));
+    } else if ((opline->op1.num & ZEND_FETCH_CLASS_MASK) == ZEND_FETCH_CLASS_PARENT) {
+        name = strpprintf(0, "parent::%s", Z_STRVAL_P(constant));
+    } else {
+        /* static:: resolves differently for every called class */
+        return NULL;
+    }
+
+    seen = zend_hash_find(&lint->constants, name);
+
+    if (seen && Z_TYPE_P(seen) == IS_FALSE) {
+        zend_string_release(name);
+        return NULL;
+    }
+
+    /* report the second lookup, or the first one inside a loop, once */
+    if (seen || (lint->flags[opline - ops->opcodes] & EXPLAIN_LINT_IN_LOOP)) {
+        zend_string *message = strpprintf(0, "constant %s is looked up %s", ZSTR_VAL(name),
+            seen ? "more than once" : "on every iteration of a loop");
+
+        ZVAL_FALSE(&reported);
+        zend_hash_update(&lint->constants, name, &reported);
+        zend_string_release(name);
+
+        return message;
+    }
+
+    ZVAL_TRUE(&reported);
+    zend_hash_add(&lint->constants, name, &reported);
+    zend_string_release(name);
+
+    return NULL;
+} /* }}} */
+
+static const explain_lint_rule_t explain_lint_rules[] = {
+    {EXPLAIN_LINT_LOOP_CONDITION, "loop-condition-call", sizeof("loop-condition-call") - 1,
+        explain_lint_loop_condition, {
+            ZEND_INIT_FCALL, ZEND_INIT_FCALL_BY_NAME, ZEND_INIT_NS_FCALL_BY_NAME, ZEND_STRLEN, 0}},
+    {EXPLAIN_LINT_DYNAMIC_FETCH, "dynamic-fetch", sizeof("dynamic-fetch") - 1,
+        explain_lint_dynamic_fetch, {
+            ZEND_FETCH_R, ZEND_FETCH_W, ZEND_FETCH_RW, ZEND_FETCH_IS, ZEND_FETCH_UNSET, ZEND_FETCH_FUNC_ARG,
+            ZEND_FETCH_OBJ_R, ZEND_FETCH_OBJ_W, ZEND_FETCH_OBJ_RW, ZEND_FETCH_OBJ_IS, ZEND_FETCH_OBJ_UNSET,
+            ZEND_FETCH_OBJ_FUNC_ARG, ZEND_ASSIGN_OBJ, ZEND_ISSET_ISEMPTY_PROP_OBJ, ZEND_UNSET_OBJ, 0}},
+    {EXPLAIN_LINT_LOOP_CONCAT, "loop-concat", sizeof("loop-concat") - 1,
+        explain_lint_loop_concat, {ZEND_ASSIGN, 0}},
+    {EXPLAIN_LINT_NS_FCALL, "ns-fcall", sizeof("ns-fcall") - 1,
+        explain_lint_ns_fcall, {ZEND_INIT_NS_FCALL_BY_NAME, 0}},
+    {EXPLAIN_LINT_REPEATED_CONSTANT, "repeated-constant", sizeof("repeated-constant") - 1,
+        explain_lint_repeated_constant, {
+            ZEND_FETCH_CONSTANT,
+#ifdef ZEND_FETCH_CLASS_CONSTANT
+            ZEND_FETCH_CLASS_CONSTANT,
+#endif
+            0}},
+    {0, NULL, 0, NULL, {0}}
+};
+
+/* rules by opcode, as indexes into explain_lint_rules */
+static uint32_t explain_lint_dispatch[256];
+
+static inline void explain_lint_startup(void) { /* {{{ */
+    uint32_t rule, trigger;
+
+    for (rule = 0; explain_lint_rules[rule].name; rule++) {
+        for (trigger = 0; trigger < EXPLAIN_LINT_TRIGGERS && explain_lint_rules[rule].triggers[trigger]; trigger++) {
+            explain_lint_dispatch[explain_lint_rules[rule].triggers[trigger]] |= (1 << rule);
+        }
+    }
+} /* }}} */
+
+static inline void explain_lint_mark(zend_uchar *flags, int32_t from, int32_t to, zend_uchar flag) { /* {{{ */
+    for (; from <= to; from++) {
+        flags[from] |= flag;
+    }
+} /* }}} */
+
+/* {{{ every opline a jump may continue at, besides the next one */
+static inline uint32_t explain_lint_targets(zend_op_array *ops, uint32_t next, int32_t *targets) {
+    zend_op *opline = &ops->opcodes[next];
+    const explain_opcode_t *decode = explain_opcode_decode(opline->opcode);
+    uint32_t count = 0;
+
+    if (!decode) {
+        return 0;
+    }
+
+    if (decode->kind & EXPLAIN_OP1_OPLINE) {
+        targets[count++] = explain_jmp_line(ops, &opline->op1, next);
+    }
+
+    if (decode->kind & EXPLAIN_OP2_OPLINE) {
+        targets[count++] = explain_jmp_line(ops, &opline->op2, next);
+    }
+
+    if (decode->kind & EXPLAIN_EXT_OPLINE) {
+        targets[count++] = EXT_LINE(opline->extended_value, next);
+    }
+
+    return count;
+} /* }}} */
+
+#define EXPLAIN_LINT_TEMP(ops, node) (EX_VAR_TO_NUM((node).var) - (ops)->last_var)
+
+/* {{{ a loop tested at the bottom, as do-while is, has no entry jump to find
+    its condition by, and the condition does not start a basic block unless
+    something continues to it; instead the condition is walked back from the
+    back edge over the oplines that compute the value it tests, whole calls
+    and the jumps of && || and ?: included */
+static uint32_t explain_lint_condition(zend_op_array *ops, uint32_t from, uint32_t branch) {
+    zend_op *opline = &ops->opcodes[branch];
+    zend_uchar *needed;
+    uint32_t start = branch, calls = 0;
+
+    if (!(opline->op1_type & (IS_TMP_VAR|IS_VAR))) {
+        return branch;
+    }
+
+    needed = ecalloc(ops->T, 1);
+    needed[EXPLAIN_LINT_TEMP(ops, opline->op1)] = 1;
+
+    while (start > from) {
+        int32_t targets[3];
+        uint32_t count, it;
+        zend_bool within = 0;
+
+        opline = &ops->opcodes[start - 1];
+
+        if (!calls && !((opline->result_type & (IS_TMP_VAR|IS_VAR)) && needed[EXPLAIN_LINT_TEMP(ops, opline->result)])) {
+            count = explain_lint_targets(ops, start - 1, targets);
+
+            for (it = 0; it < count; it++) {
+                if (targets[it] >= (int32_t) start && (uint32_t) targets[it] <= branch) {
+                    within = 1;
+                }
+            }
+
+            if (!within) {
+                break;
+            }
+        }
+
+        switch (opline->opcode) {
+            case ZEND_DO_FCALL:
+            case ZEND_DO_ICALL:
+            case ZEND_DO_UCALL:
+            case ZEND_DO_FCALL_BY_NAME:
+                calls++;
+                break;
+
+            case ZEND_INIT_FCALL:
+            case ZEND_INIT_FCALL_BY_NAME:
+            case ZEND_INIT_NS_FCALL_BY_NAME:
+            case ZEND_INIT_METHOD_CALL:
+            case ZEND_INIT_STATIC_METHOD_CALL:
+            case ZEND_INIT_USER_CALL:
+            case ZEND_INIT_DYNAMIC_CALL:
+                if (calls) {
+                    calls--;
+                }
+                break;
+        }
+
+        if (opline->op1_type & (IS_TMP_VAR|IS_VAR)) {
+            needed[EXPLAIN_LINT_TEMP(ops, opline->op1)] = 1;
+        }
+
+        if (opline->op2_type & (IS_TMP_VAR|IS_VAR)) {
+            needed[EXPLAIN_LINT_TEMP(ops, opline->op2)] = 1;
+        }
+
+        start--;
+    }
+
+    efree(needed);
+
+    return start;
+} /* }}} */
+
+static void explain_lint_loops(zend_op_array *ops, zend_uchar *flags) { /* {{{ */
+    uint32_t next;
+
+    for (next = 0; next < ops->last; next++) {
+        int32_t targets[3], entry;
+        uint32_t count = explain_lint_targets(ops, next, targets), it;
+
+        for (it = 0; it < count; it++) {
+            int32_t target = targets[it];
+
+            /* JMPZNZ may jump back through either of its targets */
+            if (target < 0 || (uint32_t) target > next) {
+                continue;
+            }
+
+            explain_lint_mark(flags, target, next, EXPLAIN_LINT_IN_LOOP);
+
+            if (ops->opcodes[next].opcode == ZEND_JMP) {
+                continue;
+            }
+
+            if (target && ops->opcodes[target - 1].opcode == ZEND_JMP &&
+                (entry = explain_jmp_line(ops, &ops->opcodes[target - 1].op1, target - 1)) >= target &&
+                (uint32_t) entry <= next) {
+                explain_lint_mark(flags, entry, next, EXPLAIN_LINT_IN_CONDITION);
+            } else {
+                explain_lint_mark(flags, explain_lint_condition(ops, target, next), next, EXPLAIN_LINT_IN_CONDITION);
+            }
+        }
+    }
+} /* }}} */
+
+static void explain_lint_op_array(zend_op_array *ops, zend_long rules, zval *return_value) { /* {{{ */
+    explain_lint_t lint;
+    zend_string *function = NULL;
+    uint32_t next;
+
+    if (!ops->last) {
+        return;
+    }
+
+    lint.ops = ops;
+    lint.flags = ecalloc(ops->last, 1);
+
+    zend_hash_init(&lint.constants, 8, NULL, NULL, 0);
+
+    explain_lint_loops(ops, lint.flags);
+
+    for (next = 0; next < ops->last; next++) {
+        zend_op *opline = &ops->opcodes[next];
+        uint32_t matchers = explain_lint_dispatch[opline->opcode], rule;
+
+        for (rule = 0; matchers; rule++, matchers >>= 1) {
+            zend_string *message;
+            zval finding;
+
+            if (!(matchers & 1) || !(rules & explain_lint_rules[rule].rule)) {
+                continue;
+            }
+
+            if (!(message = explain_lint_rules[rule].match(&lint, opline))) {
+                continue;
+            }
+
+            if (!function) {
+                function = explain_op_array_name(ops);
+            }
+
+            array_init(&finding);
+
+            add_assoc_stringl_ex(&finding, "rule", sizeof("rule") - 1,
+                (char*) explain_lint_rules[rule].name, explain_lint_rules[rule].name_len);
+            add_assoc_str_ex(&finding, "message", sizeof("message") - 1, message);
+
+            if (ops->filename) {
+                add_assoc_str_ex(&finding, "file", sizeof("file") - 1, zend_string_copy(ops->filename));
+            } else add_assoc_null_ex(&finding, "file", sizeof("file") - 1);
+
+            add_assoc_str_ex(&finding, "function", sizeof("function") - 1, zend_string_copy(function));
+            add_assoc_long_ex(&finding, "opline", sizeof("opline") - 1, next);
+            add_assoc_long_ex(&finding, "line", sizeof("line") - 1, opline->lineno);
+
+            add_next_index_zval(return_value, &finding);
+        }
+    }
+
+    if (function) {
+        zend_string_release(function);
+    }
+
+    zend_hash_destroy(&lint.constants);
+    efree(lint.flags);
+} /* }}} */
+/* }}} */
+
+/* Every user-visible function in PHP should document itself in the source */
+/* {{{ proto string confirm_explain_compiled(string arg)
+   Return a string to confirm that the module is compiled in */
+PHP_FUNCTION(explain)
+{
+    zval *code, *classes = NULL, *functions = NULL, *types = NULL, res;
+    zend_ulong options = EXPLAIN_FILE;
+    explain_snapshot_t snapshot;
+    zend_string *name;
+    zend_class_entry *pce;
+    zend_function *pfe;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "z|lz/z/z/", &code, &options, &classes, &functions, &types) == FAILURE) {
+        return;
+    }
+
+    zend_op_array *ops = explain_compile(code, options, &snapshot);
+
+    if (!ops) {
+        RETURN_FALSE;
+    }
+
+    explain_op_array(ops, &res);
+
+    if (ZVAL_IS_NULL(&res)) {
+        explain_release(&ops, &snapshot, options);
+        zend_error(E_WARNING, "explain was unable to compile code");
+        RETURN_FALSE;
+    }
+
+    if (types) {
+        zval_dtor(types);
+        array_init(types);
+    }
+
+    explain_types(ops, options, &res, types);
+
+    if (classes) {
+        if (Z_TYPE_P(classes) != IS_ARRAY) {
+            zval_dtor(classes);
+            array_init(classes);
+        }
+
+        EXPLAIN_FOREACH_DECLARED(CG(class_table), snapshot.classes, name, pce) {
+            if (pce->type == ZEND_USER_CLASS) {
+                zval zce;
+
+                explain_class_methods(pce, options, &zce, types);
+
+                add_assoc_zval_ex(classes, ZSTR_VAL(pce->name), ZSTR_LEN(pce->name), &zce);
+            }
+        } EXPLAIN_FOREACH_END();
+    }
+
+    if (functions) {
+        if (Z_TYPE_P(functions) != IS_ARRAY) {
+            zval_dtor(functions);
+            array_init(functions);
+        }
+
+        EXPLAIN_FOREACH_DECLARED(CG(function_table), snapshot.functions, name, pfe) {
+            if (pfe->common.type == ZEND_USER_FUNCTION) {
+                zval zfe;
+
+                explain_op_array(&pfe->op_array, &zfe);
+                explain_types(&pfe->op_array, options, &zfe, types);
+
+                add_assoc_zval_ex(functions, ZSTR_VAL(name), ZSTR_LEN(name), &zfe);
+            }
+        } EXPLAIN_FOREACH_END();
+    }
+
+    if (options & EXPLAIN_INDEX) {
+        explain_index_compiled(&EX_G(index), ops, &snapshot);
+    }
+
+    explain_release(&ops, &snapshot, options);
+
+    RETURN_ZVAL(&res, 0, 0);
+
+}
+/* }}} */
+
+/* {{{ proto integer explain_export(string code, resource stream [, integer format = EXPLAIN_EXPORT_NDJSON [, integer options = EXPLAIN_FILE]])
+    explain code straight into stream as NDJSON or MessagePack, one record per opline or per op_array */
+PHP_FUNCTION(explain_export)
+{
+    zval *code, *zstream;
+    zend_long format = EXPLAIN_EXPORT_NDJSON;
+    zend_long options = EXPLAIN_FILE;
+    explain_snapshot_t snapshot;
+    explain_export_t ex;
+    zend_op_array *ops;
+    zend_class_entry *pce;
+    zend_function *pfe;
+    int result = SUCCESS;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "zr|ll", &code, &zstream, &format, &options) == FAILURE) {
+        return;
+    }
+
+    if (format != EXPLAIN_EXPORT_NDJSON && format != EXPLAIN_EXPORT_MSGPACK) {
+        zend_error(E_WARNING, "invalid format passed to explain_export (%ld), please see documentation", format);
+        RETURN_FALSE;
+    }
+
+    memset(&ex, 0, sizeof(explain_export_t));
+
+    php_stream_from_zval(ex.stream, zstream);
+
+    ex.format = format;
+    ex.options = options;
+
+    ops = explain_compile(code, options, &snapshot);
+
+    if (!ops) {
+        RETURN_FALSE;
+    }
+
+    ex.file = ops->filename;
+
+    result = explain_export_op_array(&ex, ops);
+
+    EXPLAIN_FOREACH_DECLARED_PTR(CG(class_table), snapshot.classes, pce) {
+        if (result != SUCCESS) {
+            break;
+        }
+
+        if (pce->type != ZEND_USER_CLASS) {
+            continue;
+        }
+
+        ZEND_HASH_FOREACH_PTR(&pce->function_table, pfe) {
+            if (pfe->common.type == ZEND_USER_FUNCTION && pfe->common.scope == pce) {
+                if ((result = explain_export_op_array(&ex, &pfe->op_array)) != SUCCESS) {
+                    break;
+                }
+            }
+        } ZEND_HASH_FOREACH_END();
+    } EXPLAIN_FOREACH_END();
+
+    EXPLAIN_FOREACH_DECLARED_PTR(CG(function_table), snapshot.functions, pfe) {
+        if (result != SUCCESS) {
+            break;
+        }
+
+        if (pfe->common.type == ZEND_USER_FUNCTION) {
+            result = explain_export_op_array(&ex, &pfe->op_array);
+        }
+    } EXPLAIN_FOREACH_END();
+
+    if (result == SUCCESS) {
+        result = explain_export_flush(&ex, 1);
+    }
+
+    if (options & EXPLAIN_INDEX) {
+        explain_index_compiled(&EX_G(index), ops, &snapshot);
+    }
+
+    smart_str_free(&ex.buf);
+    explain_release(&ops, &snapshot, options);
+
+    if (result != SUCCESS) {
+        zend_error(E_WARNING, "explain_export failed to write to stream");
+        RETURN_FALSE;
+    }
+
+    RETURN_LONG(ex.records);
+}
+/* }}} */
+
+/* {{{ proto array explain_diff(string old, string new [, integer options = EXPLAIN_FILE])
+    compare the bytecode of two versions of code, function by function */
+PHP_FUNCTION(explain_diff)
+{
+    zval *before, *after;
+    zend_ulong options = EXPLAIN_FILE;
+    explain_diff_side_t sides[2];
+    zend_string *name;
+    zend_op_array *ops;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "zz|l", &before, &after, &options) == FAILURE) {
+        return;
+    }
+
+    memset(sides, 0, sizeof(sides));
+
+    if (explain_diff_compile(before, options, &sides[0]) != SUCCESS) {
+        RETURN_FALSE;
+    }
+
+    if (explain_diff_compile(after, options, &sides[1]) != SUCCESS) {
+        explain_diff_release(&sides[0]);
+        RETURN_FALSE;
+    }
+
+    array_init(return_value);
+
+    ZEND_HASH_FOREACH_STR_KEY_PTR(&sides[0].units, name, ops) {
+        explain_diff_op_arrays(name, ops, zend_hash_find_ptr(&sides[1].units, name), return_value);
+    } ZEND_HASH_FOREACH_END();
+
+    ZEND_HASH_FOREACH_STR_KEY_PTR(&sides[1].units, name, ops) {
+        if (!zend_hash_exists(&sides[0].units, name)) {
+            explain_diff_op_arrays(name, NULL, ops, return_value);
+        }
+    } ZEND_HASH_FOREACH_END();
+
+    explain_diff_release(&sides[0]);
+    explain_diff_release(&sides[1]);
+}
+/* }}} */
+
+/* {{{ proto array explain_function(mixed function [, integer options = 0 [, array &types]])
+    explain a loaded function, method or closure without compiling anything */
+PHP_FUNCTION(explain_function)
+{
+    zval *function, *types = NULL;
+    zend_ulong options = 0;
+    zend_function *pfe;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "z|lz/", &function, &options, &types) == FAILURE) {
+        return;
+    }
+
+    pfe = explain_loaded_function(function);
+
+    if (!pfe) {
+        zend_error(E_WARNING, "explain_function expects a loaded function, method or closure");
+        RETURN_FALSE;
+    }
+
+    if (pfe->common.type != ZEND_USER_FUNCTION) {
+        zend_error(E_WARNING, "%s is an internal function and has no bytecode", ZSTR_VAL(pfe->common.function_name));
+        RETURN_FALSE;
+    }
+
+    if (types) {
+        zval_dtor(types);
+        array_init(types);
+    }
+
+    explain_op_array(&pfe->op_array, return_value);
+    explain_types(&pfe->op_array, options, return_value, types);
+}
+/* }}} */
+
+/* {{{ proto array explain_class(string class [, integer options = 0 [, array &types]])
+    explain every user method of a loaded class without compiling anything */
+PHP_FUNCTION(explain_class)
+{
+    zend_string *name;
+    zval *types = NULL;
+    zend_ulong options = 0;
+    zend_class_entry *pce;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "S|lz/", &name, &options, &types) == FAILURE) {
+        return;
+    }
+
+    pce = explain_loaded_class(ZSTR_VAL(name), ZSTR_LEN(name));
+
+    if (!pce) {
+        zend_error(E_WARNING, "class %s is not loaded", ZSTR_VAL(name));
+        RETURN_FALSE;
+    }
+
+    if (pce->type != ZEND_USER_CLASS) {
+        zend_error(E_WARNING, "%s is an internal class and has no bytecode", ZSTR_VAL(pce->name));
+        RETURN_FALSE;
+    }
+
+    if (types) {
+        zval_dtor(types);
+        array_init(types);
+    }
+
+    explain_class_methods(pce, options, return_value, types);
+}
+/* }}} */
+
+/* {{{ proto array explain_lint(string code [, integer options = EXPLAIN_FILE [, integer rules = EXPLAIN_LINT_ALL]])
+    find performance anti-patterns in the bytecode of code, declarations are always rolled back */
+PHP_FUNCTION(explain_lint)
+{
+    zval *code;
+    zend_ulong options = EXPLAIN_FILE;
+    zend_long rules = EXPLAIN_LINT_ALL;
+    explain_snapshot_t snapshot;
+    zend_op_array *ops;
+    zend_class_entry *pce;
+    zend_function *pfe;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "z|ll", &code, &options, &rules) == FAILURE) {
+        return;
+    }
+
+    /* linting a tree must not declare it */
+    options |= EXPLAIN_ISOLATE;
+
+    ops = explain_compile(code, options, &snapshot);
+
+    if (!ops) {
+        RETURN_FALSE;
+    }
+
+    array_init(return_value);
+
+    explain_lint_op_array(ops, rules, return_value);
+
+    EXPLAIN_FOREACH_DECLARED_PTR(CG(class_table), snapshot.classes, pce) {
+        if (pce->type == ZEND_USER_CLASS) {
+            ZEND_HASH_FOREACH_PTR(&pce->function_table, pfe) {
+                /* inherited methods are linted with the class declaring them */
+                if (pfe->common.type == ZEND_USER_FUNCTION && pfe->common.scope == pce) {
+                    explain_lint_op_array(&pfe->op_array, rules, return_value);
+                }
+            } ZEND_HASH_FOREACH_END();
+        }
+    } EXPLAIN_FOREACH_END();
+
+    EXPLAIN_FOREACH_DECLARED_PTR(CG(function_table), snapshot.functions, pfe) {
+        if (pfe->common.type == ZEND_USER_FUNCTION) {
+            explain_lint_op_array(&pfe->op_array, rules, return_value);
+        }
+    } EXPLAIN_FOREACH_END();
+
+    explain_release(&ops, &snapshot, options);
+}
+/* }}} */
+
+/* {{{ proto bool explain_index_save(string path)
+    write everything indexed by EXPLAIN_INDEX during this request to path */
+PHP_FUNCTION(explain_index_save)
+{
+    zend_string *path;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "P", &path) == FAILURE) {
+        return;
+    }
+
+    /* the same file may be cached under other spellings of its path,
+        every cached index could be stale once this one is written */
+    zend_hash_clean(&EX_G(indexes));
+
+    if (explain_index_save(&EX_G(index), ZSTR_VAL(path)) != SUCCESS) {
+        zend_error(E_WARNING, "explain failed to write index to %s", ZSTR_VAL(path));
+        RETURN_FALSE;
+    }
+
+    RETURN_TRUE;
+}
+/* }}} */
+
+/* {{{ proto array explain_index_query(string index, string symbol [, integer type = EXPLAIN_INDEX_CALLERS])
+    query a saved index for the declarations of, the callers of, or the calls made by symbol */
+PHP_FUNCTION(explain_index_query)
+{
+    zend_string *path, *symbol;
+    zend_long type = EXPLAIN_INDEX_CALLERS;
+    explain_index_view_t view;
+    uint32_t id;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "PS|l", &path, &symbol, &type) == FAILURE) {
+        return;
+    }
+
+    if (type != EXPLAIN_INDEX_SYMBOLS && type != EXPLAIN_INDEX_CALLERS && type != EXPLAIN_INDEX_CALLEES) {
+        zend_error(E_WARNING, "invalid type passed to explain_index_query (%ld), please see documentation", type);
+        RETURN_FALSE;
+    }
+
+    if (explain_index_open(path, &view) != SUCCESS) {
+        RETURN_FALSE;
+    }
+
+    array_init(return_value);
+
+    /* file paths are stored as they are, everything else is lowercase */
+    if (explain_index_find(&view, ZSTR_VAL(symbol), ZSTR_LEN(symbol), &id)) {
+        explain_index_query(&view, id, type, return_value);
+    } else {
+        zend_string *lower = zend_string_tolower(symbol);
+
+        if (explain_index_find(&view, ZSTR_VAL(lower), ZSTR_LEN(lower), &id)) {
+            explain_index_query(&view, id, type, return_value);
+        }
+
+        zend_string_release(lower);
+    }
+}
+/* }}} */
+
+/* {{{ proto string explain_opcode(integer opcode)
+    get the friendly name for an opcode */
+PHP_FUNCTION(explain_opcode) {
+    zend_long opcode;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "l", &opcode) == FAILURE) {
+        return;
+    }
+
+    explain_opcode(opcode, return_value);
+} /* }}} */
+
+/* {{{ proto string explain_optype(integer optype)
+    get the friendly name for an optype */
+PHP_FUNCTION(explain_optype) {
+    long optype;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS() TSRMLS_CC, "l", &optype) == FAILURE) {
+        return;
+    }
+
+    explain_optype((zend_uchar)optype, return_value);
+} /* }}} */
+
+/* {{{ */
+static inline void php_explain_globals_ctor(zend_explain_globals *eg) {} /* }}} */
+
+/* {{{ PHP_MINIT_FUNCTION
+ */
+PHP_MINIT_FUNCTION(explain)
+{
+    ZEND_INIT_MODULE_GLOBALS(explain, php_explain_globals_ctor, NULL);
+
+    explain_opcodes_startup();
+    explain_lint_startup();
+
+    REGISTER_LONG_CONSTANT("EXPLAIN_STRING",          EXPLAIN_STRING,      CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("EXPLAIN_FILE",            EXPLAIN_FILE,        CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("EXPLAIN_OPLINE",          EXPLAIN_OPLINE,      CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("EXPLAIN_ISOLATE",         EXPLAIN_ISOLATE,     CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("EXPLAIN_INDEX",           EXPLAIN_INDEX,       CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("EXPLAIN_TYPES",           EXPLAIN_TYPES,       CONST_CS | CONST_PERSISTENT);
+
+    REGISTER_LONG_CONSTANT("EXPLAIN_IS_UNUSED",       IS_UNUSED,           CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("EXPLAIN_IS_VAR",          IS_VAR,              CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("EXPLAIN_IS_TMP_VAR",      IS_TMP_VAR,          CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("EXPLAIN_IS_CV",           IS_CV,               CONST_CS | CONST_PERSISTENT);
+#ifdef EXT_TYPE_UNUSED
+    REGISTER_LONG_CONSTANT("EXPLAIN_EXT_TYPE_UNUSED", EXT_TYPE_UNUSED,     CONST_CS | CONST_PERSISTENT);
+#endif
+
+    REGISTER_LONG_CONSTANT("EXPLAIN_EXPORT_NDJSON",   EXPLAIN_EXPORT_NDJSON,   CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("EXPLAIN_EXPORT_MSGPACK",  EXPLAIN_EXPORT_MSGPACK,  CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("EXPLAIN_EXPORT_OP_ARRAY", EXPLAIN_EXPORT_OP_ARRAY, CONST_CS | CONST_PERSISTENT);
+
+    REGISTER_LONG_CONSTANT("EXPLAIN_INDEX_SYMBOLS",   EXPLAIN_INDEX_SYMBOLS,   CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("EXPLAIN_INDEX_CALLERS",   EXPLAIN_INDEX_CALLERS,   CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("EXPLAIN_INDEX_CALLEES",   EXPLAIN_INDEX_CALLEES,   CONST_CS | CONST_PERSISTENT);
+
+    REGISTER_LONG_CONSTANT("EXPLAIN_LINT_LOOP_CONDITION",    EXPLAIN_LINT_LOOP_CONDITION,    CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("EXPLAIN_LINT_DYNAMIC_FETCH",     EXPLAIN_LINT_DYNAMIC_FETCH,     CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("EXPLAIN_LINT_LOOP_CONCAT",       EXPLAIN_LINT_LOOP_CONCAT,       CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("EXPLAIN_LINT_NS_FCALL",          EXPLAIN_LINT_NS_FCALL,          CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("EXPLAIN_LINT_REPEATED_CONSTANT", EXPLAIN_LINT_REPEATED_CONSTANT, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("EXPLAIN_LINT_ALL",               EXPLAIN_LINT_ALL,               CONST_CS | CONST_PERSISTENT);
+
+	return SUCCESS;
+}
+/* }}} */
+
+/* {{{ PHP_MSHUTDOWN_FUNCTION
+ */
+PHP_MSHUTDOWN_FUNCTION(explain)
+{
+	/* uncomment this line if you have INI entries
+	UNREGISTER_INI_ENTRIES();
+	*/
+	return SUCCESS;
+}
+/* }}} */
+
+/* Remove if there's nothing to do at request start */
+/* {{{ PHP_RINIT_FUNCTION
+ */
+PHP_RINIT_FUNCTION(explain)
+{
+#if defined(COMPILE_DL_EXPLAIN) && defined(ZTS)
+	ZEND_TSRMLS_CACHE_UPDATE();
+#endif
+
+    zend_hash_init(&EX_G(explained), 8, NULL, (dtor_func_t) php_explain_destroy_ops, 0);
+    zend_hash_init(&EX_G(zval_cache), 8, NULL, (dtor_func_t) ZVAL_PTR_DTOR, 0);
+    zend_hash_init(&EX_G(indexes), 8, NULL, (dtor_func_t) explain_index_file_free, 0);
+
+    explain_index_init(&EX_G(index));
+
+	return SUCCESS;
+}
+/* }}} */
+
+/* Remove if there's nothing to do at request end */
+/* {{{ PHP_RSHUTDOWN_FUNCTION
+ */
+PHP_RSHUTDOWN_FUNCTION(explain)
+{
+    zend_hash_destroy(&EX_G(explained));
+    zend_hash_destroy(&EX_G(zval_cache));
+    zend_hash_destroy(&EX_G(indexes));
+
+    explain_index_destroy(&EX_G(index));
+
+	return SUCCESS;
+}
+/* }}} */
+
+/* {{{ PHP_MINFO_FUNCTION
+ */
+PHP_MINFO_FUNCTION(explain)
+{
+	php_info_print_table_start();
 	php_info_print_table_header(2, "explain support", "enabled");
 	php_info_print_table_end();
 
@@ -517,6 +4154,48 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_explain, 0, 0, 1)
                 ZEND_ARG_INFO(0, options)
                 ZEND_ARG_INFO(1, classes)
                 ZEND_ARG_INFO(1, functions)
+                ZEND_ARG_INFO(1, types)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_explain_export, 0, 0, 2)
+                ZEND_ARG_INFO(0, code)
+                ZEND_ARG_INFO(0, stream)
+                ZEND_ARG_INFO(0, format)
+                ZEND_ARG_INFO(0, options)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_explain_diff, 0, 0, 2)
+                ZEND_ARG_INFO(0, old)
+                ZEND_ARG_INFO(0, new)
+                ZEND_ARG_INFO(0, options)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_explain_function, 0, 0, 1)
+                ZEND_ARG_INFO(0, function)
+                ZEND_ARG_INFO(0, options)
+                ZEND_ARG_INFO(1, types)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_explain_class, 0, 0, 1)
+                ZEND_ARG_INFO(0, class)
+                ZEND_ARG_INFO(0, options)
+                ZEND_ARG_INFO(1, types)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_explain_lint, 0, 0, 1)
+                ZEND_ARG_INFO(0, code)
+                ZEND_ARG_INFO(0, options)
+                ZEND_ARG_INFO(0, rules)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_explain_index_save, 0, 0, 1)
+                ZEND_ARG_INFO(0, path)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_explain_index_query, 0, 0, 2)
+                ZEND_ARG_INFO(0, index)
+                ZEND_ARG_INFO(0, symbol)
+                ZEND_ARG_INFO(0, type)
 ZEND_END_ARG_INFO()
 
 ZEND_BEGIN_ARG_INFO_EX(arginfo_explain_opcode, 0, 0, 1)
@@ -532,7 +4211,14 @@ ZEND_END_ARG_INFO()
  * Every user visible function must have an entry in explain_functions[].
  */
 const zend_function_entry explain_functions[] = {
-	PHP_FE(explain,	NULL)
+	PHP_FE(explain,	arginfo_explain)
+    PHP_FE(explain_export, arginfo_explain_export)
+    PHP_FE(explain_diff, arginfo_explain_diff)
+    PHP_FE(explain_function, arginfo_explain_function)
+    PHP_FE(explain_class, arginfo_explain_class)
+    PHP_FE(explain_lint, arginfo_explain_lint)
+    PHP_FE(explain_index_save, arginfo_explain_index_save)
+    PHP_FE(explain_index_query, arginfo_explain_index_query)
     PHP_FE(explain_opcode, arginfo_explain_opcode)
     PHP_FE(explain_optype, arginfo_explain_optype)
 	PHP_FE_END	/* Must be the last line in explain_functions[] */
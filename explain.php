@@ -90,7 +90,7 @@ if (is_dir($input)) {
     $name = substr($file, strlen($input));
     $classes[$name] = $functions[$name] = '';
     $explained[$name] = explain(
-      $file, EXPLAIN_FILE, $classes[$name], $functions[$name]);
+      $file, EXPLAIN_FILE|EXPLAIN_ISOLATE, $classes[$name], $functions[$name]);
       foreach (preg_split("~(\n)~", file_get_contents($file)) as $line) {
         if (function_exists('gzcompress')) {
           $lines[$name][] = gzcompress($line);
@@ -106,7 +106,7 @@ if (is_dir($input)) {
     }
     $classes[$input] = $functions[$input] = '';
     $explained[$input] = explain(
-      $input, EXPLAIN_FILE, $classes[$input], $functions[$input]);
+      $input, EXPLAIN_FILE|EXPLAIN_ISOLATE, $classes[$input], $functions[$input]);
   } else $explained = false;
 }
 ?>
@@ -0,0 +1,53 @@
+# explain_opcodes.awk
+#
+# Generates explain_opcodes.h from the target PHP's Zend/zend_vm_opcodes.h
+#
+#  awk -f explain_opcodes.awk explain_opcodes.kinds zend_vm_opcodes.h explain_opcodes.h.in > explain_opcodes.h
+#
+# Every opcode defined by the VM gets a slot in the table at its own number,
+# gaps are left zeroed, so decoding an opline is a single index operation.
+#
+# The operand kinds come from explain_opcodes.kinds, which config.w32 reads
+# too; on PHP >= 7.1 MINIT refines them further from the flags the VM exports.
+
+BEGIN {
+	file = 0
+	count = 0
+}
+
+FNR == 1 {
+	file++
+}
+
+# first file: explain_opcodes.kinds
+file == 1 {
+	if (NF >= 2 && $1 !~ /^#/) {
+		kinds[$1] = $2
+	}
+	next
+}
+
+# second file: zend_vm_opcodes.h
+file == 2 {
+	if ($1 == "#define" && $2 ~ /^ZEND_/ && $2 !~ /^ZEND_VM_/ && $3 ~ /^[0-9]+$/) {
+		names[count++] = $2
+	}
+	next
+}
+
+# third file: explain_opcodes.h.in
+/\{opcodes\}/ {
+	if (count == 0) {
+		print "explain_opcodes.awk: no opcodes found" > "/dev/stderr"
+		exit 1
+	}
+
+	for (i = 0; i < count; i++) {
+		kind = (names[i] in kinds) ? kinds[names[i]] : "0"
+
+		printf "\t[%s] = EXPLAIN_OPCODE_NAME(%s, %s),\n", names[i], names[i], kind
+	}
+	next
+}
+
+{ print }
@@ -38,9 +38,37 @@ extern zend_module_entry explain_module_entry;
 #include "TSRM.h"
 #endif
 
+/* {{{ symbol index records, strings are referenced by id */
+typedef struct _explain_index_symbol_t {
+  uint32_t name;
+  uint32_t file;
+  uint32_t line;
+  uint32_t kind;
+} explain_index_symbol_t;
+
+typedef struct _explain_index_call_t {
+  uint32_t caller;
+  uint32_t callee;
+  uint32_t file;
+  uint32_t line;
+  uint32_t opcode;
+} explain_index_call_t;
+
+typedef struct _explain_index_t {
+  HashTable strings;
+  explain_index_symbol_t *symbols;
+  uint32_t symbols_count;
+  uint32_t symbols_size;
+  explain_index_call_t *calls;
+  uint32_t calls_count;
+  uint32_t calls_size;
+} explain_index_t; /* }}} */
+
 ZEND_BEGIN_MODULE_GLOBALS(explain)
   HashTable explained;
   HashTable zval_cache;
+  explain_index_t index;
+  HashTable indexes;
 ZEND_END_MODULE_GLOBALS(explain)
 
 #ifdef ZTS
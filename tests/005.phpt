@@ -0,0 +1,29 @@
+--TEST--
+Check opcode table decoding
+--SKIPIF--
+<?php if (!extension_loaded("explain")) print "skip"; ?>
+--FILE--
+<?php 
+var_dump(explain_opcode(0), explain_opcode(-1), explain_opcode(PHP_INT_MAX));
+
+$explained = explain(<<<HERE
+for (\$i = 0; \$i < 10; \$i++) {
+	echo \$i;
+}
+HERE
+, EXPLAIN_STRING);
+
+foreach ($explained as $opline) {
+	foreach (array("op1", "op2") as $op) {
+		if ($opline["{$op}_type"] == EXPLAIN_OPLINE) {
+			var_dump($opline[$op] >= 0 && $opline[$op] < count($explained));
+		}
+	}
+}
+?>
+--EXPECTF--
+string(8) "ZEND_NOP"
+string(7) "unknown"
+string(7) "unknown"
+bool(true)
+bool(true)
@@ -0,0 +1,73 @@
+--TEST--
+Check export to stream
+--SKIPIF--
+<?php if (!extension_loaded("explain")) print "skip"; ?>
+--FILE--
+<?php 
+$code = function($id) {
+	return <<<HERE
+function greet{$id}(\$who) {
+	return "Hello " . \$who;
+}
+echo greet{$id}("World");
+HERE;
+};
+
+$stream = fopen("php://memory", "w+");
+$records = explain_export($code(1), $stream, EXPLAIN_EXPORT_NDJSON, EXPLAIN_STRING);
+rewind($stream);
+
+$lines = 0;
+while (($line = fgets($stream))) {
+	$record = json_decode($line, true);
+	if (!isset($record["opline"], $record["name"], $record["lineno"])) {
+		var_dump($line);
+	}
+	$lines++;
+}
+var_dump($records == $lines, $records > 0);
+
+$stream = fopen("php://memory", "w+");
+var_dump(explain_export($code(2), $stream, EXPLAIN_EXPORT_NDJSON, EXPLAIN_STRING|EXPLAIN_EXPORT_OP_ARRAY));
+rewind($stream);
+$main = json_decode(fgets($stream), true);
+var_dump($main["function"], count($main["oplines"]) > 0);
+
+$stream = fopen("php://memory", "w+");
+var_dump(explain_export($code(3), $stream, EXPLAIN_EXPORT_MSGPACK, EXPLAIN_STRING|EXPLAIN_EXPORT_OP_ARRAY));
+rewind($stream);
+var_dump(ord(fread($stream, 1)) & 0xf0);
+
+$stream = fopen("php://memory", "w+");
+explain_export('$x = 1.5 + $y + 1.0; echo "caf' . "\xe9" . '";', $stream, EXPLAIN_EXPORT_NDJSON, EXPLAIN_STRING);
+rewind($stream);
+
+$values = array();
+while (($line = fgets($stream))) {
+	$record = json_decode($line, true);
+	if ($record === null) {
+		var_dump($line);
+		continue;
+	}
+	array_walk_recursive($record, function($value) use(&$values) {
+		$values[] = $value;
+	});
+}
+var_dump(in_array(1.5, $values, true), in_array(1.0, $values, true), in_array("caf\u{fffd}", $values, true));
+
+var_dump(explain_export($code(4), $stream, 42, EXPLAIN_STRING));
+?>
+--EXPECTF--
+bool(true)
+bool(true)
+int(2)
+NULL
+bool(true)
+int(2)
+int(128)
+bool(true)
+bool(true)
+bool(true)
+
+Warning: invalid format passed to explain_export (42), please see documentation in %s on line %d
+bool(false)
@@ -0,0 +1,48 @@
+--TEST--
+Check isolated compilation
+--SKIPIF--
+<?php if (!extension_loaded("explain")) print "skip"; ?>
+--FILE--
+<?php 
+$code = <<<HERE
+class Isolated {
+	public function method() {}
+}
+function isolated() {}
+HERE;
+
+for ($i = 0; $i < 3; $i++) {
+	$classes = $functions = array();
+	explain($code, EXPLAIN_STRING|EXPLAIN_ISOLATE, $classes, $functions);
+	var_dump(array_keys($classes), array_keys($functions));
+}
+
+var_dump(class_exists("Isolated", false), function_exists("isolated"));
+?>
+--EXPECT--
+array(1) {
+  [0]=>
+  string(8) "Isolated"
+}
+array(1) {
+  [0]=>
+  string(8) "isolated"
+}
+array(1) {
+  [0]=>
+  string(8) "Isolated"
+}
+array(1) {
+  [0]=>
+  string(8) "isolated"
+}
+array(1) {
+  [0]=>
+  string(8) "Isolated"
+}
+array(1) {
+  [0]=>
+  string(8) "isolated"
+}
+bool(false)
+bool(false)
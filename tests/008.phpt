@@ -0,0 +1,87 @@
+--TEST--
+Check symbol and call site index
+--SKIPIF--
+<?php if (!extension_loaded("explain")) print "skip"; ?>
+--FILE--
+<?php 
+explain(<<<HERE
+class Indexed {
+	public function run() {
+		return indexed_helper(\$this->prepare());
+	}
+	public function prepare() {}
+}
+function indexed_helper(\$value) {
+	return strlen(\$value);
+}
+(new Indexed)->run();
+eval("return 1;");
+HERE
+, EXPLAIN_STRING|EXPLAIN_ISOLATE|EXPLAIN_INDEX);
+
+$path = sprintf("%s/explain-%d.idx", sys_get_temp_dir(), getmypid());
+
+var_dump(explain_index_save($path));
+
+foreach (explain_index_query($path, "Indexed::Run", EXPLAIN_INDEX_SYMBOLS) as $symbol) {
+	printf("%s %s %d\n", $symbol["kind"], $symbol["name"], $symbol["line"]);
+}
+
+foreach (explain_index_query($path, "indexed_helper", EXPLAIN_INDEX_CALLERS) as $call) {
+	printf("%s -> %s %d\n", $call["caller"], $call["callee"], $call["line"]);
+}
+
+foreach (explain_index_query($path, "indexed::run", EXPLAIN_INDEX_CALLEES) as $call) {
+	printf("%s -> %s %d\n", $call["caller"], $call["callee"], $call["line"]);
+}
+
+var_dump(explain_index_query($path, "nothing"));
+
+/* eval is called with code, which is not a callee */
+var_dump(explain_index_query($path, "return 1;"));
+
+/* saving through another spelling of the path drops what is cached for $path */
+explain('function indexed_later() {}', EXPLAIN_STRING|EXPLAIN_ISOLATE|EXPLAIN_INDEX);
+var_dump(explain_index_save(dirname($path) . "/./" . basename($path)));
+
+foreach (explain_index_query($path, "indexed_later", EXPLAIN_INDEX_SYMBOLS) as $symbol) {
+	printf("%s %s %d\n", $symbol["kind"], $symbol["name"], $symbol["line"]);
+}
+
+/* same size, but the first symbol names a string past the end */
+$data = file_get_contents($path);
+$header = unpack("a8magic/Lversion/Lstrings/Lblob/Lsymbols/Lcalls", $data);
+$symbols = 32 + ($header["strings"] + 1) * 4 + (($header["blob"] + 3) & ~3);
+$bad = "{$path}.bad";
+
+file_put_contents($bad, substr_replace($data, pack("L", 0xffffffff), $symbols, 4));
+var_dump(explain_index_query($bad, "indexed_helper"));
+
+/* valid ids, but the first two symbols swapped */
+$unsorted = "{$path}.unsorted";
+
+file_put_contents($unsorted, substr_replace($data, substr($data, $symbols + 16, 16) . substr($data, $symbols, 16), $symbols, 32));
+var_dump(explain_index_query($unsorted, "indexed_helper"));
+
+unlink($bad);
+unlink($unsorted);
+unlink($path);
+?>
+--EXPECTF--
+bool(true)
+method indexed::run 2
+indexed::run -> indexed_helper 3
+indexed::run -> indexed::prepare 3
+indexed::run -> indexed_helper 3
+array(0) {
+}
+array(0) {
+}
+bool(true)
+function indexed_later 1
+
+Warning: %s.bad is a corrupted explain index in %s on line %d
+bool(false)
+
+Warning: %s.unsorted is an unsorted explain index in %s on line %d
+bool(false)
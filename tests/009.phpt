@@ -0,0 +1,88 @@
+--TEST--
+Check bytecode diff
+--SKIPIF--
+<?php if (!extension_loaded("explain")) print "skip"; ?>
+--FILE--
+<?php 
+$old = <<<HERE
+class Differ {
+	public function same(\$a) {
+		return \$a + 1;
+	}
+	public function loop(\$items) {
+		\$total = 0;
+		foreach (\$items as \$item) {
+			\$total += \$item;
+		}
+		return \$total;
+	}
+}
+function removed() {}
+HERE;
+
+$new = <<<HERE
+class Differ {
+	public function same(\$a) {
+		return \$a + 1;
+	}
+	public function loop(\$items) {
+		\$total = 0;
+		foreach (\$items as \$item) {
+			\$total += \$item * 2;
+		}
+		return \$total;
+	}
+}
+function added() {}
+HERE;
+
+$diff = explain_diff($old, $new, EXPLAIN_STRING);
+
+ksort($diff);
+foreach ($diff as $name => $record) {
+	printf("%s %s %d\n", $name, $record["status"], $record["delta"]);
+}
+
+var_dump(isset($diff["differ::same"]));
+var_dump($diff["differ::loop"]["opcodes"]["ZEND_MUL"]);
+
+/* MUL is added, the compound assignment now takes a TMP instead of a CV */
+var_dump(count($diff["differ::loop"]["changes"]));
+
+var_dump(class_exists("Differ", false));
+
+/* a closure added at the top does not rename the closures declared after it */
+$old = <<<HERE
+function closures() {
+	\$double = function(\$x) { return \$x * 2; }; \$triple = function(\$x) { return \$x * 3; };
+	return array_map(\$double, array_map(\$triple, [1, 2, 3]));
+}
+HERE;
+
+$new = <<<HERE
+\$first = function() { return 0; };
+function closures() {
+	\$double = function(\$x) { return \$x * 2; }; \$triple = function(\$x) { return \$x * 4; };
+	return array_map(\$double, array_map(\$triple, [4, 5, 6]));
+}
+HERE;
+
+$diff = explain_diff($old, $new, EXPLAIN_STRING);
+
+ksort($diff);
+foreach ($diff as $name => $record) {
+	printf("%s %s %d\n", $name, $record["status"], $record["delta"]);
+}
+?>
+--EXPECTF--
+added added 1
+differ::loop changed 1
+removed removed -1
+bool(false)
+int(1)
+int(3)
+bool(false)
+closures changed 0
+closures/{closure}:1#2 changed 0
+{main} changed 2
+{main}/{closure}:%d added 2
@@ -0,0 +1,74 @@
+--TEST--
+Check inferred types
+--SKIPIF--
+<?php if (!extension_loaded("explain")) print "skip"; ?>
+--FILE--
+<?php 
+$code = <<<HERE
+function typed(int \$a, \$s) {
+	\$i = \$a * 2;
+	return \$s . \$i;
+}
+function mixed(\$b) {
+	if (\$b) {
+		\$y = 1;
+	} else {
+		\$y = "s";
+	}
+	return \$y;
+}
+function byref(&\$x) {
+	\$x = 1;
+	return \$x;
+}
+HERE;
+
+$classes = $functions = $types = array();
+explain($code, EXPLAIN_STRING|EXPLAIN_ISOLATE|EXPLAIN_TYPES, $classes, $functions, $types);
+
+var_dump(array_keys($types));
+
+foreach ($functions["typed"] as $opline) {
+	switch (explain_opcode($opline["opcode"])) {
+		case "ZEND_MUL":
+			var_dump($opline["op1_types"], $opline["result_types"]);
+		break;
+
+		case "ZEND_CONCAT":
+			var_dump($opline["result_types"]);
+		break;
+	}
+}
+
+foreach ($functions["mixed"] as $opline) {
+	if (explain_opcode($opline["opcode"]) == "ZEND_RETURN") {
+		var_dump($opline["op1_types"], in_array($opline["opline"], $types["mixed"]));
+		break;
+	}
+}
+
+foreach ($functions["byref"] as $opline) {
+	if (explain_opcode($opline["opcode"]) == "ZEND_RETURN") {
+		var_dump($opline["op1_types"], in_array($opline["opline"], $types["byref"]));
+		break;
+	}
+}
+?>
+--EXPECT--
+array(4) {
+  [0]=>
+  string(6) "{main}"
+  [1]=>
+  string(5) "typed"
+  [2]=>
+  string(5) "mixed"
+  [3]=>
+  string(5) "byref"
+}
+string(4) "long"
+string(11) "long|double"
+string(6) "string"
+string(11) "long|string"
+bool(true)
+string(8) "long|ref"
+bool(true)
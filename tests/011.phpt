@@ -0,0 +1,54 @@
+--TEST--
+Check explaining loaded functions and classes
+--SKIPIF--
+<?php if (!extension_loaded("explain")) print "skip"; ?>
+--FILE--
+<?php 
+function loaded($a) {
+	return $a + 1;
+}
+
+class Loaded {
+	public function a() {}
+	private function b($x) {
+		return $x;
+	}
+}
+
+function opcodes($oplines) {
+	return implode(",", array_map(function($opline) {
+		return explain_opcode($opline["opcode"]);
+	}, $oplines));
+}
+
+var_dump(opcodes(explain_function("loaded")));
+var_dump(opcodes(explain_function("\\LOADED")));
+var_dump(opcodes(explain_function("Loaded::b")));
+var_dump(opcodes(explain_function(array(new Loaded, "a"))));
+var_dump(opcodes(explain_function(function() { return 1; })));
+var_dump(array_keys(explain_class("Loaded")));
+var_dump(explain_function("strlen"));
+var_dump(explain_function("missing"));
+var_dump(explain_class("Missing"));
+?>
+--EXPECTF--
+string(42) "ZEND_RECV,ZEND_ADD,ZEND_RETURN,ZEND_RETURN"
+string(42) "ZEND_RECV,ZEND_ADD,ZEND_RETURN,ZEND_RETURN"
+string(33) "ZEND_RECV,ZEND_RETURN,ZEND_RETURN"
+string(11) "ZEND_RETURN"
+string(23) "ZEND_RETURN,ZEND_RETURN"
+array(2) {
+  [0]=>
+  string(1) "a"
+  [1]=>
+  string(1) "b"
+}
+
+Warning: strlen is an internal function and has no bytecode in %s on line %d
+bool(false)
+
+Warning: explain_function expects a loaded function, method or closure in %s on line %d
+bool(false)
+
+Warning: class Missing is not loaded in %s on line %d
+bool(false)
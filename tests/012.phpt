@@ -0,0 +1,79 @@
+--TEST--
+Check linting bytecode
+--SKIPIF--
+<?php if (!extension_loaded("explain")) print "skip"; ?>
+--FILE--
+<?php 
+define("LINT_SEP", ",");
+
+$code = <<<HERE
+function loop(\$items, \$o, \$name) {
+	\$s = \$t = "";
+	for (\$i = 0; \$i < count(\$items); \$i++) {
+		\$s = \$s . \$items[\$i] . LINT_SEP;
+		\$t .= LINT_SEP;
+	}
+	\$v = \$\$name;
+	return \$o->\$name . \$s . \$t . LINT_SEP;
+}
+HERE;
+
+$findings = explain_lint($code, EXPLAIN_STRING);
+
+var_dump(implode(",", array_keys($findings[0])));
+
+foreach ($findings as $finding) {
+	printf("%s %s %d %s\n", $finding["rule"], $finding["function"], $finding["line"], $finding["message"]);
+}
+
+var_dump(count(explain_lint($code, EXPLAIN_STRING, EXPLAIN_LINT_DYNAMIC_FETCH)));
+
+/* a do-while condition is found without an entry jump, for(;;) has none */
+$code = <<<HERE
+function bottom(\$items, \$s) {
+	\$i = 0;
+	do {
+		\$s = \$s . "x";
+	} while (\$i++ < count(\$items));
+	for (;;) {
+		\$s = \$s . "y";
+		if (count(\$items) > \$i++) {
+			break;
+		}
+	}
+	return \$s;
+}
+HERE;
+
+foreach (explain_lint($code, EXPLAIN_STRING) as $finding) {
+	printf("%s %s %s\n", $finding["rule"], $finding["function"], $finding["message"]);
+}
+
+$code = <<<HERE
+namespace Lint;
+
+function upper(\$s) {
+	return strtoupper(\$s);
+}
+HERE;
+
+foreach (explain_lint($code, EXPLAIN_STRING) as $finding) {
+	printf("%s %s %d %s\n", $finding["rule"], $finding["function"], $finding["line"], $finding["message"]);
+}
+
+var_dump(function_exists("loop"), function_exists("Lint\\upper"));
+?>
+--EXPECT--
+string(38) "rule,message,file,function,opline,line"
+repeated-constant loop 4 constant LINT_SEP is looked up on every iteration of a loop
+loop-concat loop 4 $s = $s . ... copies $s on every iteration of a loop, use .=
+loop-condition-call loop 3 count() is called by the loop condition on every iteration
+dynamic-fetch loop 7 variable fetched by a name only known at runtime
+dynamic-fetch loop 8 property fetched by a name only known at runtime
+int(2)
+loop-concat bottom $s = $s . ... copies $s on every iteration of a loop, use .=
+loop-condition-call bottom count() is called by the loop condition on every iteration
+loop-concat bottom $s = $s . ... copies $s on every iteration of a loop, use .=
+ns-fcall Lint\upper 4 Lint\strtoupper() falls back to \strtoupper() at runtime, write \strtoupper() or import it with use function
+bool(false)
+bool(false)
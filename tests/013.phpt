@@ -0,0 +1,37 @@
+--TEST--
+Check isolated compilation when the tables compact
+--SKIPIF--
+<?php if (!extension_loaded("explain")) print "skip"; ?>
+--FILE--
+<?php 
+/* early binding leaves a hole in the class table for every class */
+for ($i = 0; $i < 128; $i++) {
+	eval("class Hole{$i} extends ArrayObject {}");
+}
+
+$code = "";
+for ($i = 0; $i < 1024; $i++) {
+	$code .= "class Compacted{$i} extends ArrayObject {}\nfunction compacted{$i}() {}\n";
+}
+
+for ($run = 0; $run < 2; $run++) {
+	$classes = $functions = array();
+	explain($code, EXPLAIN_STRING|EXPLAIN_ISOLATE, $classes, $functions);
+	var_dump(count($classes), count($functions));
+}
+
+var_dump(class_exists("Compacted0", false), class_exists("Compacted1023", false));
+var_dump(function_exists("compacted0"), function_exists("compacted1023"));
+var_dump(class_exists("Hole0", false), class_exists("Hole127", false));
+?>
+--EXPECT--
+int(1024)
+int(1024)
+int(1024)
+int(1024)
+bool(false)
+bool(false)
+bool(false)
+bool(false)
+bool(true)
+bool(true)
@@ -0,0 +1,35 @@
+--TEST--
+Check export of doubles ignores the locale
+--SKIPIF--
+<?php
+if (!extension_loaded("explain")) print "skip";
+else if (setlocale(LC_NUMERIC, "de_DE.UTF-8", "de_DE", "de") === false) print "skip no german locale";
+?>
+--FILE--
+<?php 
+var_dump(setlocale(LC_NUMERIC, "de_DE.UTF-8", "de_DE", "de") !== false);
+var_dump(sprintf("%.1f", 1.5));
+
+$stream = fopen("php://memory", "w+");
+explain_export('$x = 1.5 + $y + 1.0;', $stream, EXPLAIN_EXPORT_NDJSON, EXPLAIN_STRING);
+setlocale(LC_NUMERIC, "C");
+rewind($stream);
+
+$values = array();
+while (($line = fgets($stream))) {
+	$record = json_decode($line, true);
+	if ($record === null) {
+		var_dump($line);
+		continue;
+	}
+	array_walk_recursive($record, function($value) use(&$values) {
+		$values[] = $value;
+	});
+}
+var_dump(in_array(1.5, $values, true), in_array(1.0, $values, true));
+?>
+--EXPECT--
+bool(true)
+string(3) "1,5"
+bool(true)
+bool(true)